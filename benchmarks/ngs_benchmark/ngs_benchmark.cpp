@@ -0,0 +1,224 @@
+#include "../../src/flat_board/flat_board.hpp"
+#include "../../src/ngs_generator/ngs_generator.hpp"
+#include "../../src/ngs_solver/ngs_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Headless no-guess generation benchmark, sweeps board sizes and mine densities through the same generator and
+ * solver code that the game uses and reports how long it takes to get a board.
+ *
+ * usage: ngs_benchmark [--seed N] [--boards N] [--time-budget SECONDS] [--mode rejection|repair|both]
+ *                      [--format csv|json|markdown]
+ *
+ * Everything runs on one thread with a fixed seed so two runs of the same build produce the same boards.
+ */
+
+struct BenchmarkConfiguration {
+    int num_cells_x;
+    int num_cells_y;
+    float mine_percentage;
+};
+
+struct BenchmarkResult {
+    std::string mode;
+    BenchmarkConfiguration configuration;
+    int mine_count;
+    int boards;
+    long attempts;
+    double mean_attempt_us;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    // the time budget ran out before the requested number of boards was generated
+    bool timed_out;
+};
+
+double percentile(std::vector<double> sorted_values, double fraction) {
+    if (sorted_values.empty()) {
+        return NAN;
+    }
+    std::size_t rank = std::ceil(fraction * sorted_values.size());
+    return sorted_values[std::clamp<std::size_t>(rank, 1, sorted_values.size()) - 1];
+}
+
+BenchmarkResult run_configuration(const std::string &mode, const BenchmarkConfiguration &configuration, int boards,
+                                  double time_budget_seconds, unsigned int seed) {
+    using clock = std::chrono::steady_clock;
+
+    int mine_count = configuration.num_cells_x * configuration.num_cells_y * configuration.mine_percentage;
+    std::mt19937 rng(seed);
+    NGSSolver solver;
+
+    long attempts = 0;
+    double total_attempt_seconds = 0;
+    std::vector<double> time_to_board_ms;
+    bool timed_out = false;
+
+    auto configuration_start = clock::now();
+    while (static_cast<int>(time_to_board_ms.size()) < boards and not timed_out) {
+        double board_seconds = 0;
+        std::optional<FlatBoard> board;
+        while (not board.has_value()) {
+            auto attempt_start = clock::now();
+            if (mode == "repair") {
+                board = try_generate_ng_solvable_board_with_local_repair(solver, mine_count, configuration.num_cells_x,
+                                                                         configuration.num_cells_y, rng);
+            } else {
+                board = try_generate_ng_solvable_board(solver, mine_count, configuration.num_cells_x,
+                                                       configuration.num_cells_y, rng);
+            }
+            double attempt_seconds = std::chrono::duration<double>(clock::now() - attempt_start).count();
+
+            attempts++;
+            total_attempt_seconds += attempt_seconds;
+            board_seconds += attempt_seconds;
+
+            if (std::chrono::duration<double>(clock::now() - configuration_start).count() > time_budget_seconds) {
+                timed_out = not board.has_value();
+                break;
+            }
+        }
+        if (board.has_value()) {
+            time_to_board_ms.push_back(board_seconds * 1000.0);
+        }
+    }
+
+    std::sort(time_to_board_ms.begin(), time_to_board_ms.end());
+    return {mode,
+            configuration,
+            mine_count,
+            static_cast<int>(time_to_board_ms.size()),
+            attempts,
+            attempts > 0 ? total_attempt_seconds * 1e6 / attempts : NAN,
+            percentile(time_to_board_ms, 0.50),
+            percentile(time_to_board_ms, 0.95),
+            percentile(time_to_board_ms, 0.99),
+            timed_out};
+}
+
+std::string format_number(double value, int precision) {
+    if (std::isnan(value)) {
+        return "";
+    }
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(precision) << value;
+    return stream.str();
+}
+
+void print_csv(const std::vector<BenchmarkResult> &results) {
+    std::cout << "mode,width,height,mines,mine_percentage,boards,attempts,mean_attempt_us,p50_ms,p95_ms,p99_ms,"
+                 "timed_out\n";
+    for (const auto &r : results) {
+        std::cout << r.mode << "," << r.configuration.num_cells_x << "," << r.configuration.num_cells_y << ","
+                  << r.mine_count << "," << format_number(r.configuration.mine_percentage * 100, 0) << ","
+                  << r.boards << "," << r.attempts << "," << format_number(r.mean_attempt_us, 1) << ","
+                  << format_number(r.p50_ms, 3) << "," << format_number(r.p95_ms, 3) << ","
+                  << format_number(r.p99_ms, 3) << "," << (r.timed_out ? "true" : "false") << "\n";
+    }
+}
+
+void print_json(const std::vector<BenchmarkResult> &results) {
+    auto json_number = [](double value, int precision) {
+        std::string formatted = format_number(value, precision);
+        return formatted.empty() ? std::string("null") : formatted;
+    };
+
+    std::cout << "[\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto &r = results[i];
+        std::cout << "  {\"mode\": \"" << r.mode << "\", \"width\": " << r.configuration.num_cells_x
+                  << ", \"height\": " << r.configuration.num_cells_y << ", \"mines\": " << r.mine_count
+                  << ", \"boards\": " << r.boards << ", \"attempts\": " << r.attempts
+                  << ", \"mean_attempt_us\": " << json_number(r.mean_attempt_us, 1)
+                  << ", \"p50_ms\": " << json_number(r.p50_ms, 3) << ", \"p95_ms\": " << json_number(r.p95_ms, 3)
+                  << ", \"p99_ms\": " << json_number(r.p99_ms, 3)
+                  << ", \"timed_out\": " << (r.timed_out ? "true" : "false") << "}"
+                  << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "]\n";
+}
+
+void print_markdown(const std::vector<BenchmarkResult> &results) {
+    std::cout << "| mode | board | mines | boards | attempts/board | attempt (us) | p50 (ms) | p95 (ms) | p99 (ms) |\n";
+    std::cout << "|---|---|---|---|---|---|---|---|---|\n";
+    for (const auto &r : results) {
+        std::string boards = std::to_string(r.boards) + (r.timed_out ? " (timed out)" : "");
+        double attempts_per_board = r.boards > 0 ? static_cast<double>(r.attempts) / r.boards : NAN;
+        std::cout << "| " << r.mode << " | " << r.configuration.num_cells_x << "x" << r.configuration.num_cells_y
+                  << " | " << r.mine_count << " (" << format_number(r.configuration.mine_percentage * 100, 0)
+                  << "%) | " << boards << " | " << format_number(attempts_per_board, 1) << " | "
+                  << format_number(r.mean_attempt_us, 1) << " | " << format_number(r.p50_ms, 2) << " | "
+                  << format_number(r.p95_ms, 2) << " | " << format_number(r.p99_ms, 2) << " |\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int seed = 12345;
+    int boards = 50;
+    double time_budget_seconds = 30;
+    std::string mode = "both";
+    std::string format = "csv";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        if (flag == "--seed") {
+            seed = std::stoul(value);
+        } else if (flag == "--boards") {
+            boards = std::stoi(value);
+        } else if (flag == "--time-budget") {
+            time_budget_seconds = std::stod(value);
+        } else if (flag == "--mode") {
+            mode = value;
+        } else if (flag == "--format") {
+            format = value;
+        } else {
+            std::cerr << "unknown flag: " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    // the sizes from the readme plus the standard intermediate and expert boards
+    const std::vector<std::pair<int, int>> sizes = {{10, 10}, {16, 16}, {20, 20}, {30, 16}};
+    const std::vector<float> mine_percentages = {0.10, 0.15, 0.20, 0.23, 0.25, 0.30, 0.35};
+
+    std::vector<std::string> modes;
+    if (mode == "both" or mode == "rejection") {
+        modes.push_back("rejection");
+    }
+    if (mode == "both" or mode == "repair") {
+        modes.push_back("repair");
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto &m : modes) {
+        for (const auto &[num_cells_x, num_cells_y] : sizes) {
+            for (float mine_percentage : mine_percentages) {
+                results.push_back(run_configuration(m, {num_cells_x, num_cells_y, mine_percentage}, boards,
+                                                    time_budget_seconds, seed));
+                std::cerr << "finished " << m << " " << num_cells_x << "x" << num_cells_y << " at "
+                          << mine_percentage * 100 << "%" << std::endl;
+            }
+        }
+    }
+
+    if (format == "json") {
+        print_json(results);
+    } else if (format == "markdown") {
+        print_markdown(results);
+    } else {
+        print_csv(results);
+    }
+    return 0;
+}
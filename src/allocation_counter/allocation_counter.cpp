@@ -0,0 +1,66 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+std::atomic<std::size_t> heap_allocation_count{0};
+// constant initialized, so touching it from operator new can't itself allocate
+thread_local std::size_t heap_allocation_count_on_this_thread = 0;
+
+void *counted_allocate(std::size_t size) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    heap_allocation_count_on_this_thread++;
+    // malloc(0) may return null, operator new has to return something unique
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *counted_allocate_aligned(std::size_t size, std::align_val_t alignment) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    heap_allocation_count_on_this_thread++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    // msvc has no aligned_alloc, its aligned blocks have to go back through _aligned_free
+    void *pointer = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc wants the size to be a multiple of the alignment
+    std::size_t rounded_size = (size + align - 1) / align * align;
+    void *pointer = std::aligned_alloc(align, rounded_size == 0 ? align : rounded_size);
+#endif
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void free_aligned(void *pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+} // namespace
+
+std::size_t get_heap_allocation_count() { return heap_allocation_count.load(std::memory_order_relaxed); }
+
+std::size_t get_heap_allocation_count_on_this_thread() { return heap_allocation_count_on_this_thread; }
+
+// the array and nothrow forms forward to these in the standard library
+
+void *operator new(std::size_t size) { return counted_allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return counted_allocate_aligned(size, alignment); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { free_aligned(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { free_aligned(pointer); }
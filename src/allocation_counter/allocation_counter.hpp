@@ -0,0 +1,22 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+/**
+ * @brief How many times the global operator new has been called so far, on any thread.
+ *
+ * Linking this module in replaces the global operator new and delete with ones that count and then forward to
+ * malloc and free, take the difference between two calls to see how much a stretch of code allocates.
+ *
+ * @note allocations made directly with malloc, or by C libraries, aren't seen.
+ */
+std::size_t get_heap_allocation_count();
+
+/**
+ * @brief Same as get_heap_allocation_count but only counts the calling thread's allocations, so one thread's
+ * steady state can be checked while others are busy.
+ */
+std::size_t get_heap_allocation_count_on_this_thread();
+
+#endif // ALLOCATION_COUNTER_HPP
@@ -0,0 +1,146 @@
+#include "board_prefetch_queue.hpp"
+#include <algorithm>
+#include <optional>
+
+namespace {
+// a quarter of the budget goes to the component pool, the rest (at least one) to the workers
+unsigned int num_component_threads(unsigned int num_threads) { return std::max(1u, num_threads / 4); }
+unsigned int num_workers(unsigned int num_threads) {
+    return std::max(1u, num_threads - std::min(num_threads, num_component_threads(num_threads)));
+}
+} // namespace
+
+BoardPrefetchQueue::BoardPrefetchQueue(unsigned int capacity, unsigned int num_threads, BoardStore *board_store)
+    : capacity(capacity == 0 ? 1 : capacity), board_store(board_store),
+      component_pool(num_component_threads(num_threads)), abandon_attempt(num_workers(num_threads)) {
+    workers.reserve(abandon_attempt.size());
+    for (unsigned int i = 0; i < abandon_attempt.size(); i++) {
+        workers.emplace_back(&BoardPrefetchQueue::worker_loop, this, i);
+    }
+}
+
+BoardPrefetchQueue::~BoardPrefetchQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        configuration_generation++;
+        abandon_attempts();
+    }
+    space_available.notify_all();
+    board_ready.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+bool BoardPrefetchQueue::set_configuration(int mine_count, int num_cells_x, int num_cells_y, bool no_guess,
+                                           NGSGenerationMode generation_mode) {
+    if (not can_generate_board(mine_count, num_cells_x, num_cells_y, no_guess, generation_mode)) {
+        return false;
+    }
+
+    BoardConfiguration new_configuration{mine_count, num_cells_x, num_cells_y, no_guess, generation_mode};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (has_configuration and new_configuration == configuration) {
+            return true;
+        }
+        configuration = new_configuration;
+        has_configuration = true;
+        configuration_generation++;
+        abandon_attempts();
+        boards.clear();
+    }
+    space_available.notify_all();
+    return true;
+}
+
+FlatBoard BoardPrefetchQueue::pop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (boards.empty() and board_store != nullptr and configuration.no_guess) {
+        BoardConfiguration current_configuration = configuration;
+        lock.unlock();
+        std::optional<FlatBoard> stored_board = board_store->draw(
+            current_configuration.mine_count, current_configuration.num_cells_x, current_configuration.num_cells_y);
+        if (stored_board.has_value()) {
+            return std::move(stored_board.value());
+        }
+        lock.lock();
+    }
+    board_ready.wait(lock, [&] { return not boards.empty(); });
+
+    FlatBoard board = std::move(boards.front());
+    boards.pop_front();
+    lock.unlock();
+
+    space_available.notify_one();
+    return board;
+}
+
+std::size_t BoardPrefetchQueue::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return boards.size();
+}
+
+void BoardPrefetchQueue::abandon_attempts() {
+    for (auto &abandon : abandon_attempt) {
+        abandon.store(true, std::memory_order_relaxed);
+    }
+}
+
+void BoardPrefetchQueue::worker_loop(unsigned int worker_index) {
+    std::atomic<bool> &abandon = abandon_attempt[worker_index];
+    NGSSolver solver(&component_pool);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // only queued boards count against the capacity, while there is room every worker races on the current
+        // configuration so the first board (the one pop is usually waiting on) comes from whoever gets lucky first
+        space_available.wait(lock, [&] { return stopping or (has_configuration and boards.size() < capacity); });
+        if (stopping) {
+            return;
+        }
+
+        BoardConfiguration job = configuration;
+        unsigned int job_generation = configuration_generation;
+        // cleared under the mutex, so a configuration change can't slip in between this and taking the job
+        abandon.store(false, std::memory_order_relaxed);
+        lock.unlock();
+
+        // a configuration change or the queue filling up stops the attempt in progress, the checks below then drop
+        // the job
+        std::optional<FlatBoard> board;
+        while (not board.has_value()) {
+            if (job.no_guess and job.generation_mode == NGSGenerationMode::LOCAL_REPAIR) {
+                board = try_generate_ng_solvable_board_with_local_repair(solver, job.mine_count, job.num_cells_x,
+                                                                         job.num_cells_y, abandon);
+            } else if (job.no_guess) {
+                board = try_generate_ng_solvable_board(solver, job.mine_count, job.num_cells_x, job.num_cells_y,
+                                                       abandon);
+            } else {
+                board = generate_flat_board(job.mine_count, job.num_cells_x, job.num_cells_y);
+            }
+
+            std::lock_guard<std::mutex> check_lock(mutex);
+            if (job_generation != configuration_generation or boards.size() >= capacity) {
+                break;
+            }
+            // the queue may have filled and been popped again since this worker was told to give up, so the
+            // next attempt has to start with the flag cleared or it would return straight away
+            abandon.store(false, std::memory_order_relaxed);
+        }
+
+        if (board.has_value() and job.no_guess and board_store != nullptr) {
+            board_store->append(board.value(), job.mine_count);
+        }
+
+        lock.lock();
+        if (board.has_value() and job_generation == configuration_generation and boards.size() < capacity) {
+            boards.push_back(std::move(board.value()));
+            if (boards.size() >= capacity) {
+                // every other attempt in progress would only produce a board with nowhere to go
+                abandon_attempts();
+            }
+            board_ready.notify_one();
+        }
+    }
+}
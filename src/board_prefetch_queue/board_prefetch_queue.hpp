@@ -0,0 +1,100 @@
+#ifndef BOARD_PREFETCH_QUEUE_HPP
+#define BOARD_PREFETCH_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../board_store/board_store.hpp"
+#include "../flat_board/flat_board.hpp"
+#include "../ngs_generator/ngs_generator.hpp"
+#include "../thread_pool/thread_pool.hpp"
+
+struct BoardConfiguration {
+    int mine_count;
+    int num_cells_x;
+    int num_cells_y;
+    bool no_guess;
+    NGSGenerationMode generation_mode;
+
+    bool operator==(const BoardConfiguration &other) const {
+        return mine_count == other.mine_count and num_cells_x == other.num_cells_x and
+               num_cells_y == other.num_cells_y and no_guess == other.no_guess and
+               generation_mode == other.generation_mode;
+    }
+    bool operator!=(const BoardConfiguration &other) const { return not(*this == other); }
+};
+
+/**
+ * @brief Bounded producer/consumer queue of ready to play boards for a single board configuration.
+ *
+ * Worker threads keep the queue topped up to its capacity in the background so that starting the next game only
+ * has to pop a board instead of generating one on the render thread. The capacity bounds queued boards only, every
+ * worker keeps attempting until the queue is full and then the attempts still in progress are abandoned. Changing
+ * the configuration throws away every queued board, and workers abandon whatever they were generating for the old
+ * configuration mid attempt.
+ *
+ * The given thread budget is split between the workers and a work stealing pool that their solvers share for large
+ * frontier components, a worker waiting on a component runs pool tasks itself so the pool only needs a fraction of
+ * the budget.
+ *
+ * When given a board store every no-guess board the workers generate is also appended to it, and popping with an
+ * empty queue draws a stored board instead of waiting on the workers.
+ */
+class BoardPrefetchQueue {
+  public:
+    BoardPrefetchQueue(unsigned int capacity, unsigned int num_threads, BoardStore *board_store = nullptr);
+    ~BoardPrefetchQueue();
+
+    BoardPrefetchQueue(const BoardPrefetchQueue &) = delete;
+    BoardPrefetchQueue &operator=(const BoardPrefetchQueue &) = delete;
+
+    /**
+     * @brief Starts prefetching boards for the given configuration, does nothing if it is already the current one.
+     * @return false, keeping the current configuration, if no board can be generated for the new one.
+     */
+    bool set_configuration(int mine_count, int num_cells_x, int num_cells_y, bool no_guess,
+                           NGSGenerationMode generation_mode = NGSGenerationMode::REJECTION_SAMPLING);
+
+    /**
+     * @brief Takes the oldest ready board, falling back to the board store and then to blocking until one is
+     * available if the queue is empty.
+     */
+    FlatBoard pop();
+
+    std::size_t size();
+
+  private:
+    void worker_loop(unsigned int worker_index);
+
+    /**
+     * @brief Makes every worker give up the attempt it is in the middle of, call with the mutex held.
+     */
+    void abandon_attempts();
+
+    unsigned int capacity;
+    BoardStore *board_store;
+
+    WorkStealingThreadPool component_pool;
+
+    std::mutex mutex;
+    std::condition_variable board_ready;
+    std::condition_variable space_available;
+
+    std::deque<FlatBoard> boards;
+    BoardConfiguration configuration{};
+    bool has_configuration = false;
+    // bumped every time the configuration changes so workers can tell their board is stale
+    unsigned int configuration_generation = 0;
+    bool stopping = false;
+    // one per worker, set to make its current attempt give up. a single shared flag couldn't be cleared by a worker
+    // starting on the new configuration without un-cancelling the others still busy with the old one
+    std::vector<std::atomic<bool>> abandon_attempt;
+
+    std::vector<std::thread> workers;
+};
+
+#endif // BOARD_PREFETCH_QUEUE_HPP
@@ -0,0 +1,246 @@
+#include "board_store.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char board_file_magic[4] = {'C', 'J', 'M', 'B'};
+constexpr std::uint16_t board_file_version = 1;
+constexpr std::size_t board_file_header_size = 16;
+constexpr std::uint32_t no_safe_start = 0xFFFFFFFF;
+
+// everything on disk is little endian so the files can be copied between machines
+void write_u16(std::uint8_t *destination, std::uint16_t value) {
+    destination[0] = value & 0xFF;
+    destination[1] = value >> 8;
+}
+
+void write_u32(std::uint8_t *destination, std::uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        destination[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+std::uint16_t read_u16(const std::uint8_t *source) { return source[0] | (source[1] << 8); }
+
+std::uint32_t read_u32(const std::uint8_t *source) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= std::uint32_t(source[i]) << (8 * i);
+    }
+    return value;
+}
+
+std::size_t get_record_size(int num_cells_x, int num_cells_y) {
+    std::size_t mine_bytes = (static_cast<std::size_t>(num_cells_x) * num_cells_y + 7) / 8;
+    // keep records 4 byte aligned so the safe start index never straddles anything awkward
+    return (4 + mine_bytes + 3) & ~std::size_t(3);
+}
+
+void write_header(std::uint8_t *header, int mine_count, int num_cells_x, int num_cells_y) {
+    std::memset(header, 0, board_file_header_size);
+    std::memcpy(header, board_file_magic, 4);
+    write_u16(header + 4, board_file_version);
+    write_u16(header + 8, num_cells_x);
+    write_u16(header + 10, num_cells_y);
+    write_u32(header + 12, mine_count);
+}
+
+bool header_matches(const std::uint8_t *header, int mine_count, int num_cells_x, int num_cells_y) {
+    return std::memcmp(header, board_file_magic, 4) == 0 and read_u16(header + 4) == board_file_version and
+           read_u16(header + 8) == num_cells_x and read_u16(header + 10) == num_cells_y and
+           read_u32(header + 12) == static_cast<std::uint32_t>(mine_count);
+}
+
+void encode_board(const FlatBoard &board, std::uint8_t *record, std::size_t record_size) {
+    std::memset(record, 0, record_size);
+    write_u32(record, board.safe_start_index < 0 ? no_safe_start : board.safe_start_index);
+    std::uint8_t *mine_bits = record + 4;
+    for (int row = 0; row < board.num_cells_y; row++) {
+        for (int col = 0; col < board.num_cells_x; col++) {
+            if (board.is_mine(row, col)) {
+                int cell = row * board.num_cells_x + col;
+                mine_bits[cell >> 3] |= 1 << (cell & 7);
+            }
+        }
+    }
+}
+
+FlatBoard decode_board(const std::uint8_t *record, int num_cells_x, int num_cells_y) {
+    FlatBoard board(num_cells_x, num_cells_y);
+    int num_cells = num_cells_x * num_cells_y;
+    const std::uint8_t *mine_bits = record + 4;
+    for (int byte_index = 0; byte_index * 8 < num_cells; byte_index++) {
+        for (std::uint8_t bits = mine_bits[byte_index]; bits != 0; bits &= bits - 1) {
+            int bit = 0;
+            while (not((bits >> bit) & 1)) {
+                bit++;
+            }
+            int cell = byte_index * 8 + bit;
+            if (cell < num_cells) {
+                board.place_mine(cell / num_cells_x, cell % num_cells_x);
+            }
+        }
+    }
+
+    std::uint32_t safe_start_index = read_u32(record);
+    if (safe_start_index != no_safe_start and safe_start_index < static_cast<std::uint32_t>(num_cells)) {
+        board.set_safe_start(safe_start_index / num_cells_x, safe_start_index % num_cells_x);
+    }
+    return board;
+}
+
+} // namespace
+
+BoardStore::BoardStore(std::string directory, std::size_t max_boards_per_file)
+    : directory(std::move(directory)), max_boards_per_file(max_boards_per_file), rng(std::random_device{}()) {}
+
+BoardStore::~BoardStore() {
+    for (auto &[key, board_file] : board_files) {
+        if (board_file.append_stream != nullptr) {
+            std::fclose(board_file.append_stream);
+        }
+#ifndef _WIN32
+        if (board_file.mapping != nullptr) {
+            munmap(board_file.mapping, board_file.mapping_size);
+        }
+#endif
+    }
+}
+
+BoardStore::BoardFile &BoardStore::get_board_file(int mine_count, int num_cells_x, int num_cells_y) {
+    BoardKey key{num_cells_x, num_cells_y, mine_count};
+    auto it = board_files.find(key);
+    if (it != board_files.end()) {
+        return it->second;
+    }
+
+    BoardFile &board_file = board_files[key];
+    board_file.path = directory + "/ngs_" + std::to_string(num_cells_x) + "x" + std::to_string(num_cells_y) + "_" +
+                      std::to_string(mine_count) + ".bin";
+    board_file.record_size = get_record_size(num_cells_x, num_cells_y);
+
+    const std::uint8_t *file_data = nullptr;
+    std::size_t file_size = 0;
+
+#ifndef _WIN32
+    int fd = open(board_file.path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 and file_stat.st_size > 0) {
+            void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                board_file.mapping = mapping;
+                board_file.mapping_size = file_stat.st_size;
+                file_data = static_cast<const std::uint8_t *>(mapping);
+                file_size = file_stat.st_size;
+            }
+        }
+        // the mapping stays valid after the descriptor is closed
+        close(fd);
+    }
+#else
+    std::ifstream file(board_file.path, std::ios::binary);
+    if (file) {
+        board_file.read_records.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        file_data = board_file.read_records.data();
+        file_size = board_file.read_records.size();
+    }
+#endif
+
+    if (file_size >= board_file_header_size) {
+        if (header_matches(file_data, mine_count, num_cells_x, num_cells_y)) {
+            board_file.mapped_records = file_data + board_file_header_size;
+            // a partially written last record from a crash is ignored and overwritten by the next append
+            board_file.num_mapped_records = (file_size - board_file_header_size) / board_file.record_size;
+            std::cout << "loaded " << board_file.num_mapped_records << " stored boards from " << board_file.path
+                      << std::endl;
+        } else {
+            std::cout << "ignoring board file with unexpected header: " << board_file.path << std::endl;
+        }
+    }
+    return board_file;
+}
+
+bool BoardStore::open_for_append(BoardFile &board_file, int mine_count, int num_cells_x, int num_cells_y) {
+    if (board_file.append_stream != nullptr) {
+        return true;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (board_file.mapped_records != nullptr) {
+        std::size_t valid_size = board_file_header_size + board_file.num_mapped_records * board_file.record_size;
+        // only ever shrinks past the last whole record so the mapped boards stay readable
+        std::filesystem::resize_file(board_file.path, valid_size, error);
+        board_file.append_stream = std::fopen(board_file.path.c_str(), "ab");
+    } else {
+        board_file.append_stream = std::fopen(board_file.path.c_str(), "wb");
+        if (board_file.append_stream != nullptr) {
+            std::uint8_t header[board_file_header_size];
+            write_header(header, mine_count, num_cells_x, num_cells_y);
+            std::fwrite(header, 1, board_file_header_size, board_file.append_stream);
+        }
+    }
+
+    if (board_file.append_stream == nullptr) {
+        std::cout << "unable to open board file for writing: " << board_file.path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::optional<FlatBoard> BoardStore::draw(int mine_count, int num_cells_x, int num_cells_y) {
+    std::lock_guard<std::mutex> lock(mutex);
+    BoardFile &board_file = get_board_file(mine_count, num_cells_x, num_cells_y);
+    if (board_file.size() == 0) {
+        return std::nullopt;
+    }
+
+    std::size_t index = std::uniform_int_distribution<std::size_t>(0, board_file.size() - 1)(rng);
+    const std::uint8_t *record =
+        index < board_file.num_mapped_records
+            ? board_file.mapped_records + index * board_file.record_size
+            : board_file.appended_records.data() + (index - board_file.num_mapped_records) * board_file.record_size;
+    return decode_board(record, num_cells_x, num_cells_y);
+}
+
+void BoardStore::append(const FlatBoard &board, int mine_count) {
+    if (board.safe_start_index < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    BoardFile &board_file = get_board_file(mine_count, board.num_cells_x, board.num_cells_y);
+    if (board_file.size() >= max_boards_per_file or
+        not open_for_append(board_file, mine_count, board.num_cells_x, board.num_cells_y)) {
+        return;
+    }
+
+    std::size_t offset = board_file.appended_records.size();
+    board_file.appended_records.resize(offset + board_file.record_size);
+    std::uint8_t *record = board_file.appended_records.data() + offset;
+    encode_board(board, record, board_file.record_size);
+    board_file.num_appended_records++;
+
+    std::fwrite(record, 1, board_file.record_size, board_file.append_stream);
+    // flushed per board so a crash loses at most the board being written
+    std::fflush(board_file.append_stream);
+}
+
+std::size_t BoardStore::size(int mine_count, int num_cells_x, int num_cells_y) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return get_board_file(mine_count, num_cells_x, num_cells_y).size();
+}
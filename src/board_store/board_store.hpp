@@ -0,0 +1,89 @@
+#ifndef BOARD_STORE_HPP
+#define BOARD_STORE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../flat_board/flat_board.hpp"
+
+/**
+ * @brief Persistent cache of no-guess boards, one binary file per board size and mine count.
+ *
+ * A file is a 16 byte header followed by fixed size records, each record is the safe start index followed by the
+ * mines packed one bit per cell in row major order. The boards that were already on disk are memory mapped the first
+ * time their configuration is used, boards appended afterwards go to the end of the file and are kept in memory for
+ * the rest of the session.
+ *
+ * Every method is thread safe so board generation workers can append as they go.
+ *
+ * @note the store only holds mines and the safe start, drawn boards come back unrevealed and unflagged.
+ */
+class BoardStore {
+  public:
+    /**
+     * @param directory where the board files live, created on the first append if it doesn't exist.
+     * @param max_boards_per_file appends are dropped once a file holds this many boards.
+     */
+    explicit BoardStore(std::string directory, std::size_t max_boards_per_file = 1 << 16);
+    ~BoardStore();
+
+    BoardStore(const BoardStore &) = delete;
+    BoardStore &operator=(const BoardStore &) = delete;
+
+    /**
+     * @brief Picks a uniformly random stored board for the configuration.
+     * @return nullopt if nothing has been stored for it yet.
+     */
+    std::optional<FlatBoard> draw(int mine_count, int num_cells_x, int num_cells_y);
+
+    /**
+     * @brief Writes a board to the end of its configuration's file.
+     * @note boards without a safe start are ignored since every stored board is meant to be no-guess.
+     */
+    void append(const FlatBoard &board, int mine_count);
+
+    std::size_t size(int mine_count, int num_cells_x, int num_cells_y);
+
+  private:
+    using BoardKey = std::tuple<int, int, int>;
+
+    struct BoardFile {
+        std::string path;
+        std::size_t record_size = 0;
+
+        // boards that were on disk when the file was opened
+        const std::uint8_t *mapped_records = nullptr;
+        std::size_t num_mapped_records = 0;
+        void *mapping = nullptr;
+        std::size_t mapping_size = 0;
+        // used in place of the mapping when memory mapping isn't available
+        std::vector<std::uint8_t> read_records;
+
+        // boards appended this session
+        std::vector<std::uint8_t> appended_records;
+        std::size_t num_appended_records = 0;
+
+        std::FILE *append_stream = nullptr;
+
+        std::size_t size() const { return num_mapped_records + num_appended_records; }
+    };
+
+    BoardFile &get_board_file(int mine_count, int num_cells_x, int num_cells_y);
+    bool open_for_append(BoardFile &board_file, int mine_count, int num_cells_x, int num_cells_y);
+
+    std::string directory;
+    std::size_t max_boards_per_file;
+
+    std::mutex mutex;
+    std::map<BoardKey, BoardFile> board_files;
+    std::mt19937 rng;
+};
+
+#endif // BOARD_STORE_HPP
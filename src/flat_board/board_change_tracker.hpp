@@ -0,0 +1,65 @@
+#ifndef BOARD_CHANGE_TRACKER_HPP
+#define BOARD_CHANGE_TRACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "flat_board.hpp"
+
+enum class BoardChange {
+    NONE,
+    // only revealed or flagged cells changed
+    CELLS,
+    // a different board, or the mines or safe start moved, everything has to be redrawn
+    NEW_BOARD,
+};
+
+/**
+ * @brief Remembers the revealed and flagged planes as of the last sync, so a renderer only redraws the cells that
+ * changed since it last drew the board.
+ *
+ * Nothing is scanned while the board's revision stays put, so an idle board costs one comparison per frame.
+ */
+class BoardChangeTracker {
+  public:
+    /**
+     * @brief Compares the board against the last sync and remembers it as it is now.
+     * @param on_changed_word called as on_changed_word(word_index, changed_bits) for every word of the revealed or
+     * flagged planes that differs, only when the change is BoardChange::CELLS.
+     */
+    template <typename OnChangedWord> BoardChange sync(const FlatBoard &board, OnChangedWord &&on_changed_word) {
+        if (board.get_revision() == revision) {
+            return BoardChange::NONE;
+        }
+
+        BoardChange change = BoardChange::CELLS;
+        if (board.get_layout_revision() != layout_revision or board.revealed.size() != revealed.size()) {
+            change = BoardChange::NEW_BOARD;
+            revealed = board.revealed;
+            flagged = board.flagged;
+        } else {
+            for (std::size_t i = 0; i < revealed.size(); i++) {
+                std::uint64_t changed = (board.revealed[i] ^ revealed[i]) | (board.flagged[i] ^ flagged[i]);
+                if (changed != 0) {
+                    revealed[i] = board.revealed[i];
+                    flagged[i] = board.flagged[i];
+                    on_changed_word(i, changed);
+                }
+            }
+        }
+
+        revision = board.get_revision();
+        layout_revision = board.get_layout_revision();
+        return change;
+    }
+
+  private:
+    // boards' revisions start at 1 << 32, so a fresh tracker never matches one
+    std::uint64_t revision = 0;
+    std::uint64_t layout_revision = 0;
+    std::vector<std::uint64_t> revealed;
+    std::vector<std::uint64_t> flagged;
+};
+
+#endif // BOARD_CHANGE_TRACKER_HPP
@@ -0,0 +1,22 @@
+#include "board_conversion.hpp"
+
+FlatBoard to_flat_board(const Board &board) {
+    int num_cells_y = board.size();
+    int num_cells_x = board.empty() ? 0 : board[0].size();
+    FlatBoard flat_board(num_cells_x, num_cells_y);
+
+    for (int row = 0; row < num_cells_y; row++) {
+        for (int col = 0; col < num_cells_x; col++) {
+            const Cell &cell = board[row][col];
+            if (cell.is_mine) {
+                flat_board.place_mine(row, col);
+            }
+            flat_board.set_revealed(row, col, cell.is_revealed);
+            flat_board.set_flagged(row, col, cell.is_flagged);
+            if (cell.safe_start) {
+                flat_board.set_safe_start(row, col);
+            }
+        }
+    }
+    return flat_board;
+}
@@ -0,0 +1,14 @@
+#ifndef BOARD_CONVERSION_HPP
+#define BOARD_CONVERSION_HPP
+
+#include "flat_board.hpp"
+#include "../game_logic/game_logic.hpp"
+
+/**
+ * @brief Converts game_logic's nested Board to a FlatBoard, e.g. for boards loaded from files.
+ *
+ * Kept apart from flat_board.hpp so that code which only needs FlatBoard does not pull in game_logic.
+ */
+FlatBoard to_flat_board(const Board &board);
+
+#endif // BOARD_CONVERSION_HPP
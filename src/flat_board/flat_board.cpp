@@ -0,0 +1,187 @@
+#include "flat_board.hpp"
+#include <atomic>
+
+namespace {
+// revisions within a board count up from its base, 2^32 changes apart leaves plenty of room before two boards overlap
+std::atomic<std::uint64_t> next_revision_base{1};
+
+std::uint64_t take_revision_base() {
+    return next_revision_base.fetch_add(1, std::memory_order_relaxed) << 32;
+}
+} // namespace
+
+FlatBoard::Revision::Revision() : cells(take_revision_base()), layout(cells) {}
+
+FlatBoard::Revision::Revision(const Revision &) : Revision() {}
+
+FlatBoard::Revision &FlatBoard::Revision::operator=(const Revision &) {
+    cells = take_revision_base();
+    layout = cells;
+    return *this;
+}
+
+FlatBoard::FlatBoard(int num_cells_x, int num_cells_y)
+    : num_cells_x(num_cells_x), num_cells_y(num_cells_y), words_per_row((num_cells_x + 63) / 64),
+      // keep count rows 16 byte aligned relative to each other
+      count_stride((num_cells_x + 15) & ~15) {
+    mines.assign(words_per_row * num_cells_y, 0);
+    revealed.assign(words_per_row * num_cells_y, 0);
+    flagged.assign(words_per_row * num_cells_y, 0);
+    adjacent_mines.assign(count_stride * num_cells_y, 0);
+}
+
+void FlatBoard::set_mine(int row, int col, bool value) {
+    if (set_bit(mines, row, col, value)) {
+        int delta = value ? 1 : -1;
+        num_mines += delta;
+        if (is_revealed(row, col)) {
+            num_revealed_mines += delta;
+        }
+        revision.bump_layout();
+    }
+}
+
+void FlatBoard::set_revealed(int row, int col, bool value) {
+    if (set_bit(revealed, row, col, value)) {
+        int delta = value ? 1 : -1;
+        num_revealed += delta;
+        if (is_mine(row, col)) {
+            num_revealed_mines += delta;
+        }
+        revision.cells++;
+    }
+}
+
+void FlatBoard::adjust_adjacent_mine_counts(int row, int col, int delta) {
+    for (int r = row - 1; r <= row + 1; r++) {
+        for (int c = col - 1; c <= col + 1; c++) {
+            if ((r != row or c != col) and in_bounds(r, c)) {
+                adjacent_mines[r * count_stride + c] += delta;
+            }
+        }
+    }
+}
+
+void FlatBoard::place_mine(int row, int col) {
+    if (is_mine(row, col)) {
+        return;
+    }
+    set_mine(row, col, true);
+    adjust_adjacent_mine_counts(row, col, 1);
+}
+
+void FlatBoard::remove_mine(int row, int col) {
+    if (not is_mine(row, col)) {
+        return;
+    }
+    set_mine(row, col, false);
+    adjust_adjacent_mine_counts(row, col, -1);
+}
+
+std::uint64_t FlatBoard::valid_bits_in_word(int word_in_row) const {
+    int bits_in_word = num_cells_x - word_in_row * 64;
+    return bits_in_word >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits_in_word) - 1;
+}
+
+FlatBoard generate_flat_board(int mine_count, int num_cells_x, int num_cells_y, std::mt19937 &rng) {
+    FlatBoard board(num_cells_x, num_cells_y);
+    int num_cells = num_cells_x * num_cells_y;
+    if (mine_count > num_cells) {
+        mine_count = num_cells;
+    }
+
+    // floyd's sampling, picks mine_count distinct cells without shuffling an index array
+    for (int j = num_cells - mine_count; j < num_cells; j++) {
+        int candidate = std::uniform_int_distribution<int>(0, j)(rng);
+        if (board.is_mine(candidate / num_cells_x, candidate % num_cells_x)) {
+            candidate = j;
+        }
+        board.place_mine(candidate / num_cells_x, candidate % num_cells_x);
+    }
+    return board;
+}
+
+FlatBoard generate_flat_board(int mine_count, int num_cells_x, int num_cells_y) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return generate_flat_board(mine_count, num_cells_x, num_cells_y, rng);
+}
+
+bool reveal_cell(FlatBoard &board, int row, int col) {
+    if (board.is_revealed(row, col) or board.is_flagged(row, col)) {
+        return true;
+    }
+    if (board.is_mine(row, col)) {
+        board.set_revealed(row, col, true);
+        return false;
+    }
+
+    std::vector<int> flood_stack = {row * board.num_cells_x + col};
+    while (not flood_stack.empty()) {
+        int r = flood_stack.back() / board.num_cells_x;
+        int c = flood_stack.back() % board.num_cells_x;
+        flood_stack.pop_back();
+        if (board.is_revealed(r, c) or board.is_flagged(r, c)) {
+            continue;
+        }
+        board.set_revealed(r, c, true);
+
+        if (board.get_adjacent_mines(r, c) != 0) {
+            continue;
+        }
+        for (int nr = r - 1; nr <= r + 1; nr++) {
+            for (int nc = c - 1; nc <= c + 1; nc++) {
+                if (board.in_bounds(nr, nc) and not board.is_revealed(nr, nc)) {
+                    flood_stack.push_back(nr * board.num_cells_x + nc);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool reveal_adjacent_cells(FlatBoard &board, int row, int col) {
+    if (not board.is_revealed(row, col)) {
+        return true;
+    }
+
+    int flagged_neighbors = 0;
+    for (int r = row - 1; r <= row + 1; r++) {
+        for (int c = col - 1; c <= col + 1; c++) {
+            if (board.in_bounds(r, c) and board.is_flagged(r, c)) {
+                flagged_neighbors++;
+            }
+        }
+    }
+    if (flagged_neighbors != board.get_adjacent_mines(row, col)) {
+        return true;
+    }
+
+    bool survived = true;
+    for (int r = row - 1; r <= row + 1; r++) {
+        for (int c = col - 1; c <= col + 1; c++) {
+            if (board.in_bounds(r, c)) {
+                survived &= reveal_cell(board, r, c);
+            }
+        }
+    }
+    return survived;
+}
+
+void toggle_flag_cell(FlatBoard &board, int row, int col) {
+    if (board.is_revealed(row, col)) {
+        return;
+    }
+    board.set_flagged(row, col, not board.is_flagged(row, col));
+}
+
+void set_adjacent_cells_flags(FlatBoard &board, int row, int col, bool flagged) {
+    for (int r = row - 1; r <= row + 1; r++) {
+        for (int c = col - 1; c <= col + 1; c++) {
+            if ((r != row or c != col) and board.in_bounds(r, c) and not board.is_revealed(r, c)) {
+                board.set_flagged(r, c, flagged);
+            }
+        }
+    }
+}
+
+bool field_clear(const FlatBoard &board) { return board.get_unrevealed_safe_count() == 0; }
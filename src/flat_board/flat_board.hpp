@@ -0,0 +1,158 @@
+#ifndef FLAT_BOARD_HPP
+#define FLAT_BOARD_HPP
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Cache friendly minefield, the boolean state of every cell lives in packed bit planes.
+ *
+ * Each bit plane stores one bit per cell with every row starting on a fresh 64 bit word, so a row can be scanned a
+ * word at a time and the padding bits past num_cells_x are always zero. Adjacent mine counts are one byte per cell
+ * with their own row stride. All of this is a handful of flat allocations instead of one per row.
+ *
+ * The setters keep running counts of mines, revealed cells and flags, so win checks and progress displays don't
+ * have to scan the planes. They also bump the board's revision, so renderers can tell nothing changed without
+ * comparing the planes either.
+ *
+ * @note there is only ever one safe start cell so it is stored as an index rather than a whole plane.
+ * @note writing to the planes directly bypasses the counts and the revision, go through the setters.
+ */
+struct FlatBoard {
+    FlatBoard() = default;
+    FlatBoard(int num_cells_x, int num_cells_y);
+
+    int num_cells_x = 0;
+    int num_cells_y = 0;
+    int words_per_row = 0;
+    int count_stride = 0;
+
+    std::vector<std::uint64_t> mines;
+    std::vector<std::uint64_t> revealed;
+    std::vector<std::uint64_t> flagged;
+    std::vector<std::uint8_t> adjacent_mines;
+
+    // row * num_cells_x + col, or -1 when the board has no safe start
+    int safe_start_index = -1;
+
+    bool in_bounds(int row, int col) const { return row >= 0 and row < num_cells_y and col >= 0 and col < num_cells_x; }
+
+    bool is_mine(int row, int col) const { return test_bit(mines, row, col); }
+    bool is_revealed(int row, int col) const { return test_bit(revealed, row, col); }
+    bool is_flagged(int row, int col) const { return test_bit(flagged, row, col); }
+    bool is_safe_start(int row, int col) const { return safe_start_index == row * num_cells_x + col; }
+    int get_adjacent_mines(int row, int col) const { return adjacent_mines[row * count_stride + col]; }
+
+    void set_revealed(int row, int col, bool value);
+    void set_flagged(int row, int col, bool value) {
+        if (set_bit(flagged, row, col, value)) {
+            num_flagged += value ? 1 : -1;
+            revision.cells++;
+        }
+    }
+    void set_safe_start(int row, int col) {
+        safe_start_index = row * num_cells_x + col;
+        revision.bump_layout();
+    }
+
+    /**
+     * @brief Places or removes a mine and keeps the neighbors' adjacent mine counts in sync.
+     */
+    void place_mine(int row, int col);
+    void remove_mine(int row, int col);
+
+    /**
+     * @brief Mask of the bits in a row's word that correspond to real cells.
+     */
+    std::uint64_t valid_bits_in_word(int word_in_row) const;
+
+    int get_mine_count() const { return num_mines; }
+    int get_revealed_count() const { return num_revealed; }
+    int get_flag_count() const { return num_flagged; }
+    /**
+     * @brief Safe cells still left to reveal, the board is won once this reaches zero.
+     */
+    int get_unrevealed_safe_count() const {
+        return num_cells_x * num_cells_y - num_mines - (num_revealed - num_revealed_mines);
+    }
+
+    /**
+     * @brief Changes every time a cell does. Two boards only share a revision if one was moved from the other, a
+     * copy starts out with a revision of its own.
+     */
+    std::uint64_t get_revision() const { return revision.cells; }
+    /**
+     * @brief Like get_revision but only changes with the mines or the safe start, anything drawn from the old
+     * layout has to be redrawn from scratch.
+     */
+    std::uint64_t get_layout_revision() const { return revision.layout; }
+
+  private:
+    struct Revision {
+        // every board gets its own range of revisions, so boards can't be confused with each other
+        Revision();
+        Revision(const Revision &);
+        Revision &operator=(const Revision &);
+        Revision(Revision &&) = default;
+        Revision &operator=(Revision &&) = default;
+
+        void bump_layout() { layout = ++cells; }
+
+        std::uint64_t cells;
+        std::uint64_t layout;
+    };
+    Revision revision;
+
+    int num_mines = 0;
+    int num_revealed = 0;
+    // only ever nonzero after a loss, but the safe count mustn't count the mine that ended the game
+    int num_revealed_mines = 0;
+    int num_flagged = 0;
+
+    // only through place_mine and remove_mine, a mine without its neighbors' counts would leave them wrong
+    void set_mine(int row, int col, bool value);
+
+    bool test_bit(const std::vector<std::uint64_t> &plane, int row, int col) const {
+        return (plane[row * words_per_row + (col >> 6)] >> (col & 63)) & 1;
+    }
+    /**
+     * @return true if the bit changed
+     */
+    bool set_bit(std::vector<std::uint64_t> &plane, int row, int col, bool value) {
+        std::uint64_t &word = plane[row * words_per_row + (col >> 6)];
+        std::uint64_t mask = std::uint64_t(1) << (col & 63);
+        bool was_set = word & mask;
+        word = value ? (word | mask) : (word & ~mask);
+        return was_set != value;
+    }
+    void adjust_adjacent_mine_counts(int row, int col, int delta);
+};
+
+/**
+ * @brief Randomly places mine_count mines, every placement of that many mines is equally likely.
+ */
+FlatBoard generate_flat_board(int mine_count, int num_cells_x, int num_cells_y, std::mt19937 &rng);
+FlatBoard generate_flat_board(int mine_count, int num_cells_x, int num_cells_y);
+
+/**
+ * @brief Reveals a cell, opening up the surrounding area when it has no adjacent mines.
+ * @return false if the revealed cell was a mine.
+ */
+bool reveal_cell(FlatBoard &board, int row, int col);
+
+/**
+ * @brief Reveals every unflagged neighbor of a revealed cell once enough of its neighbors are flagged.
+ * @return false if one of the revealed neighbors was a mine.
+ */
+bool reveal_adjacent_cells(FlatBoard &board, int row, int col);
+
+void toggle_flag_cell(FlatBoard &board, int row, int col);
+void set_adjacent_cells_flags(FlatBoard &board, int row, int col, bool flagged);
+
+/**
+ * @brief True once every cell that is not a mine has been revealed, constant time from the board's counts.
+ */
+bool field_clear(const FlatBoard &board);
+
+#endif // FLAT_BOARD_HPP
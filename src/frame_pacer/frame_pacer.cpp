@@ -0,0 +1,62 @@
+#include "frame_pacer.hpp"
+
+#include <thread>
+
+FramePacer::FramePacer(FramePacingMode mode, double target_fps)
+    : frame_period(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / target_fps))),
+      next_frame_time(clock::now()) {
+    set_mode(mode);
+    glfwGetFramebufferSize(glfwGetCurrentContext(), &framebuffer_width, &framebuffer_height);
+}
+
+void FramePacer::set_mode(FramePacingMode mode) {
+    this->mode = mode;
+    glfwSwapInterval(mode == FramePacingMode::VSYNC ? 1 : 0);
+    redraw_requested = true;
+}
+
+void FramePacer::sleep_until(clock::time_point deadline) {
+    if (deadline - clock::now() > spin_margin) {
+        std::this_thread::sleep_until(deadline - spin_margin);
+    }
+    while (clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+bool FramePacer::framebuffer_resized() {
+    int width, height;
+    glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
+    bool resized = width != framebuffer_width or height != framebuffer_height;
+    framebuffer_width = width;
+    framebuffer_height = height;
+    return resized;
+}
+
+bool FramePacer::end_frame() {
+    glfwPollEvents();
+
+    if (mode == FramePacingMode::VSYNC) {
+        // the swap already waited for the display
+        redraw_requested = false;
+        return true;
+    }
+
+    if (mode == FramePacingMode::WAIT_EVENTS and not redraw_requested) {
+        glfwWaitEventsTimeout(idle_timeout_seconds);
+        // the timeout, or an event nothing on screen depends on, the last frame is still up to date
+        if (not redraw_requested and not framebuffer_resized()) {
+            return false;
+        }
+    }
+    redraw_requested = false;
+
+    clock::time_point now = clock::now();
+    next_frame_time += frame_period;
+    if (next_frame_time < now - frame_period) {
+        // fell more than a frame behind (or was idle), don't try to catch up with a burst of frames
+        next_frame_time = now;
+    }
+    sleep_until(next_frame_time);
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+enum class FramePacingMode {
+    // block on input while nothing needs redrawing, otherwise limit to the target fps
+    WAIT_EVENTS,
+    // redraw every frame at the target fps
+    LIMITED,
+    // redraw every frame and let the swap wait for the display
+    VSYNC
+};
+
+/**
+ * @brief Decides when the main loop runs its next frame, so it doesn't spin a core redrawing things that haven't
+ * changed.
+ *
+ * Call end_frame where the loop used to poll events, it polls or waits for events and sleeps as the mode requires.
+ * Input callbacks and anything else that changes what is on screen call request_redraw. While waiting for events the
+ * loop still comes around now and then without anything to redraw, end_frame reports those so the loop can skip
+ * rendering and only do its cheap background work.
+ *
+ * The limiter sleeps until shortly before the deadline and spins for the rest, since sleeping alone overshoots by
+ * the scheduler's granularity.
+ */
+class FramePacer {
+  public:
+    FramePacer(FramePacingMode mode, double target_fps);
+
+    /**
+     * @note needs the window's context to be current, vsync is set through the swap interval.
+     */
+    void set_mode(FramePacingMode mode);
+    FramePacingMode get_mode() const { return mode; }
+
+    /**
+     * @brief Makes the next end_frame return without waiting for input, requests made while handling a frame carry
+     * over to that frame's end_frame.
+     */
+    void request_redraw() { redraw_requested = true; }
+
+    /**
+     * @brief Processes events and returns once the next frame should start.
+     * @return false if the wait timed out with nothing to redraw, the previous frame is still what should be on
+     * screen. Always true outside of WAIT_EVENTS.
+     */
+    bool end_frame();
+
+  private:
+    void sleep_until(std::chrono::steady_clock::time_point deadline);
+    // resizing doesn't go through the input callbacks, so the pacer watches for it itself
+    bool framebuffer_resized();
+
+    using clock = std::chrono::steady_clock;
+
+    FramePacingMode mode;
+    clock::duration frame_period;
+    clock::time_point next_frame_time;
+    bool redraw_requested = true;
+    int framebuffer_width = 0;
+    int framebuffer_height = 0;
+
+    // even with no input the loop comes around this often, so background loads are still picked up
+    static constexpr double idle_timeout_seconds = 0.25;
+    // sleep_for routinely overshoots by about a scheduler tick, the last stretch is spun instead
+    static constexpr std::chrono::microseconds spin_margin{1500};
+};
+
+#endif // FRAME_PACER_HPP
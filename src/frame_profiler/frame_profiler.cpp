@@ -0,0 +1,210 @@
+#include "frame_profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+FrameProfiler::FrameProfiler(std::size_t history_length, std::size_t max_trace_events)
+    : history_length(history_length), max_trace_events(max_trace_events), epoch(clock::now()) {
+    frame_phase_index = get_phase_index("frame", false);
+}
+
+FrameProfiler::~FrameProfiler() {
+    for (const auto &gpu_query : gpu_queries) {
+        glDeleteQueries(1, &gpu_query.query);
+    }
+}
+
+std::int64_t FrameProfiler::to_trace_us(clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - epoch).count();
+}
+
+std::size_t FrameProfiler::get_phase_index(const char *name, bool gpu) {
+    for (std::size_t i = 0; i < phases.size(); i++) {
+        if (phases[i].gpu == gpu and (phases[i].name == name or std::strcmp(phases[i].name, name) == 0)) {
+            return i;
+        }
+    }
+    Phase phase{name, gpu};
+    phase.history.assign(history_length, 0.0);
+    phases.push_back(std::move(phase));
+    return phases.size() - 1;
+}
+
+void FrameProfiler::record_history(Phase &phase, double ms) {
+    phase.history[phase.history_next] = ms;
+    phase.history_next = (phase.history_next + 1) % history_length;
+    phase.history_count = std::min(phase.history_count + 1, history_length);
+}
+
+void FrameProfiler::record_trace_event(std::size_t phase_index, std::int64_t start_us, std::int64_t duration_us,
+                                       int thread_id) {
+    TraceEvent event{phase_index, start_us, duration_us, thread_id};
+    if (trace_events.size() < max_trace_events) {
+        trace_events.push_back(event);
+    } else {
+        trace_events[trace_next] = event;
+    }
+    trace_next = (trace_next + 1) % max_trace_events;
+}
+
+void FrameProfiler::begin_frame() {
+    if (frame_in_progress) {
+        end_frame();
+    }
+    frame_in_progress = true;
+    frame_start_us = to_trace_us(clock::now());
+}
+
+void FrameProfiler::end_frame() {
+    while (not open_phases.empty()) {
+        end_phase();
+    }
+    if (active_gpu_query != -1) {
+        end_gpu_phase();
+    }
+
+    std::int64_t frame_end_us = to_trace_us(clock::now());
+    if (frame_in_progress) {
+        record_history(phases[frame_phase_index], (frame_end_us - frame_start_us) / 1000.0);
+        record_trace_event(frame_phase_index, frame_start_us, frame_end_us - frame_start_us, 0);
+    }
+    frame_in_progress = false;
+
+    for (auto &phase : phases) {
+        if (phase.touched_this_frame) {
+            record_history(phase, phase.total_this_frame_ms);
+        }
+        phase.touched_this_frame = false;
+        phase.total_this_frame_ms = 0;
+    }
+
+    collect_gpu_queries();
+}
+
+void FrameProfiler::begin_phase(const char *name) {
+    open_phases.push_back({get_phase_index(name, false), clock::now()});
+}
+
+void FrameProfiler::end_phase() {
+    if (open_phases.empty()) {
+        return;
+    }
+    OpenPhase open_phase = open_phases.back();
+    open_phases.pop_back();
+
+    clock::time_point end = clock::now();
+    Phase &phase = phases[open_phase.phase_index];
+    phase.touched_this_frame = true;
+    phase.total_this_frame_ms += std::chrono::duration<double, std::milli>(end - open_phase.start).count();
+
+    std::int64_t start_us = to_trace_us(open_phase.start);
+    record_trace_event(open_phase.phase_index, start_us, to_trace_us(end) - start_us, 0);
+}
+
+void FrameProfiler::begin_gpu_phase(const char *name) {
+    if (active_gpu_query != -1) {
+        return;
+    }
+
+    std::size_t pending = 0;
+    int free_query = -1;
+    for (std::size_t i = 0; i < gpu_queries.size(); i++) {
+        if (gpu_queries[i].pending) {
+            pending++;
+        } else if (free_query == -1) {
+            free_query = static_cast<int>(i);
+        }
+    }
+    if (pending >= max_pending_gpu_queries) {
+        return;
+    }
+    if (free_query == -1) {
+        GLuint query;
+        glGenQueries(1, &query);
+        gpu_queries.push_back({query, 0, 0, false});
+        free_query = static_cast<int>(gpu_queries.size() - 1);
+    }
+
+    GpuQuery &gpu_query = gpu_queries[free_query];
+    gpu_query.phase_index = get_phase_index(name, true);
+    gpu_query.issued_at_us = to_trace_us(clock::now());
+    glBeginQuery(GL_TIME_ELAPSED, gpu_query.query);
+    active_gpu_query = free_query;
+}
+
+void FrameProfiler::end_gpu_phase() {
+    if (active_gpu_query == -1) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    gpu_queries[active_gpu_query].pending = true;
+    active_gpu_query = -1;
+}
+
+void FrameProfiler::collect_gpu_queries() {
+    for (auto &gpu_query : gpu_queries) {
+        if (not gpu_query.pending) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(gpu_query.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (not available) {
+            continue;
+        }
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(gpu_query.query, GL_QUERY_RESULT, &elapsed_ns);
+        gpu_query.pending = false;
+
+        // results come back frames late and out of step with the cpu phases, so each one is its own sample
+        record_history(phases[gpu_query.phase_index], elapsed_ns / 1e6);
+        record_trace_event(gpu_query.phase_index, gpu_query.issued_at_us, static_cast<std::int64_t>(elapsed_ns / 1000),
+                           1);
+    }
+}
+
+std::vector<FrameProfiler::PhaseStatistics> FrameProfiler::get_statistics() const {
+    std::vector<PhaseStatistics> statistics;
+    std::vector<double> samples;
+    for (const auto &phase : phases) {
+        if (phase.history_count == 0) {
+            continue;
+        }
+        samples.assign(phase.history.begin(), phase.history.begin() + phase.history_count);
+
+        auto percentile = [&](double p) {
+            std::size_t rank = std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()));
+            std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+            return samples[rank];
+        };
+        double p50 = percentile(0.50);
+        double p99 = percentile(0.99);
+        statistics.push_back({phase.name, phase.gpu, p50, p99});
+    }
+    return statistics;
+}
+
+bool FrameProfiler::write_chrome_trace(const std::string &path) const {
+    std::ofstream file(path);
+    if (not file) {
+        std::cout << "couldn't open " << path << " to write the frame trace" << std::endl;
+        return false;
+    }
+
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"cpu\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"gpu\"}}";
+    // once the ring buffer has wrapped the oldest event is the next one to be overwritten
+    std::size_t oldest = trace_events.size() < max_trace_events ? 0 : trace_next;
+    for (std::size_t i = 0; i < trace_events.size(); i++) {
+        const TraceEvent &event = trace_events[(oldest + i) % trace_events.size()];
+        // phase names are literals from main, nothing in them needs escaping
+        file << ",\n{\"name\":\"" << phases[event.phase_index].name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+             << event.thread_id << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}";
+    }
+    file << "\n]}\n";
+
+    std::cout << "wrote " << trace_events.size() << " trace events to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,147 @@
+#ifndef FRAME_PROFILER_HPP
+#define FRAME_PROFILER_HPP
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Times the phases of the main loop so the one worth optimizing at a given board size can be picked out.
+ *
+ * CPU phases are bracketed with begin_phase/end_phase (or a ScopedPhaseTimer), GPU phases with
+ * begin_gpu_phase/end_gpu_phase which wrap a GL_TIME_ELAPSED query. Each phase keeps a rolling window of per frame
+ * totals for percentiles, and every timed span is kept as a trace event so a recent stretch of frames can be written
+ * out and opened in chrome://tracing or Perfetto.
+ *
+ * GPU results are read back a few frames late and only once they are available, so the profiler never stalls the
+ * pipeline waiting on them.
+ *
+ * @note phase names are compared by pointer first, pass string literals.
+ */
+class FrameProfiler {
+  public:
+    struct PhaseStatistics {
+        // the literal the phase was started with, so no string is copied
+        const char *name;
+        bool gpu;
+        double p50_ms;
+        double p99_ms;
+    };
+
+    explicit FrameProfiler(std::size_t history_length = 240, std::size_t max_trace_events = 1 << 16);
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler &) = delete;
+    FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+    /**
+     * @brief Starts a frame, if the previous one was never ended (the loop hit a continue) it is ended here.
+     */
+    void begin_frame();
+    /**
+     * @brief Closes any phases still open, records this frame's totals and collects finished GPU queries.
+     */
+    void end_frame();
+
+    void begin_phase(const char *name);
+    void end_phase();
+
+    /**
+     * @note GL_TIME_ELAPSED queries can't nest, so neither can GPU phases. Needs the GL context to be current.
+     */
+    void begin_gpu_phase(const char *name);
+    void end_gpu_phase();
+
+    /**
+     * @brief p50 and p99 of each phase's per frame total over the rolling window, in the order phases were first
+     * seen.
+     */
+    std::vector<PhaseStatistics> get_statistics() const;
+
+    /**
+     * @brief Writes the recorded spans in the chrome trace event format, CPU phases on thread 0 and GPU phases on
+     * thread 1.
+     * @note GPU spans are placed at the CPU time their query was issued, only their durations are measured.
+     * @return false if the file couldn't be opened
+     */
+    bool write_chrome_trace(const std::string &path) const;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct Phase {
+        const char *name;
+        bool gpu;
+        bool touched_this_frame = false;
+        double total_this_frame_ms = 0;
+        // ring buffer of per frame totals
+        std::vector<double> history;
+        std::size_t history_next = 0;
+        std::size_t history_count = 0;
+    };
+
+    struct OpenPhase {
+        std::size_t phase_index;
+        clock::time_point start;
+    };
+
+    struct GpuQuery {
+        GLuint query;
+        std::size_t phase_index;
+        std::int64_t issued_at_us;
+        bool pending;
+    };
+
+    struct TraceEvent {
+        std::size_t phase_index;
+        std::int64_t start_us;
+        std::int64_t duration_us;
+        int thread_id;
+    };
+
+    std::size_t get_phase_index(const char *name, bool gpu);
+    void record_history(Phase &phase, double ms);
+    void record_trace_event(std::size_t phase_index, std::int64_t start_us, std::int64_t duration_us, int thread_id);
+    void collect_gpu_queries();
+    std::int64_t to_trace_us(clock::time_point time) const;
+
+    std::size_t history_length;
+    std::size_t max_trace_events;
+    clock::time_point epoch;
+
+    std::vector<Phase> phases;
+    std::vector<OpenPhase> open_phases;
+    bool frame_in_progress = false;
+    std::int64_t frame_start_us = 0;
+
+    std::vector<GpuQuery> gpu_queries;
+    // index into gpu_queries of the query between begin_gpu_phase and end_gpu_phase, if any
+    int active_gpu_query = -1;
+    // more than this many queries in flight means results aren't coming back, stop issuing new ones
+    static constexpr std::size_t max_pending_gpu_queries = 32;
+
+    // ring buffer once full, it only grows while filling up so steady state frames don't allocate
+    std::vector<TraceEvent> trace_events;
+    std::size_t trace_next = 0;
+    // whole frames are recorded as a phase too, so the others can be lined up against them
+    std::size_t frame_phase_index;
+};
+
+/**
+ * @brief Times the enclosing scope as a CPU phase of the profiler.
+ */
+class ScopedPhaseTimer {
+  public:
+    ScopedPhaseTimer(FrameProfiler &profiler, const char *name) : profiler(profiler) { profiler.begin_phase(name); }
+    ~ScopedPhaseTimer() { profiler.end_phase(); }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+    ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+  private:
+    FrameProfiler &profiler;
+};
+
+#endif // FRAME_PROFILER_HPP
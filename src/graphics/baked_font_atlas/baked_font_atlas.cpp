@@ -0,0 +1,164 @@
+#include "baked_font_atlas.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char baked_font_atlas_magic[4] = {'C', 'J', 'M', 'F'};
+constexpr std::uint32_t baked_font_atlas_version = 2;
+
+struct BakedFontAtlasHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t font_size;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t num_glyphs;
+    // from the start of the file, both 16 byte aligned
+    std::uint32_t glyphs_offset;
+    std::uint32_t texels_offset;
+};
+
+static_assert(sizeof(BakedFontAtlasHeader) == 32 and sizeof(BakedGlyph) == 32, "the file layout has changed");
+
+std::size_t align_to_16(std::size_t offset) { return (offset + 15) & ~std::size_t(15); }
+
+} // namespace
+
+BakedFontAtlas::BakedFontAtlas(const std::string &path) {
+    const std::uint8_t *file_data = nullptr;
+    std::size_t file_size = 0;
+
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("unable to open baked font atlas: " + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 and file_stat.st_size > 0) {
+        void *file_mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (file_mapping != MAP_FAILED) {
+            mapping = file_mapping;
+            mapping_size = file_stat.st_size;
+            // the texels are all read by the upload, start reading them in now
+            madvise(file_mapping, mapping_size, MADV_WILLNEED);
+            file_data = static_cast<const std::uint8_t *>(file_mapping);
+            file_size = mapping_size;
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+        throw std::runtime_error("unable to open baked font atlas: " + path);
+    }
+    file_contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    file_data = file_contents.data();
+    file_size = file_contents.size();
+#endif
+
+    BakedFontAtlasHeader header;
+    if (file_size < sizeof(header)) {
+        release();
+        throw std::runtime_error("baked font atlas is too small: " + path);
+    }
+    std::memcpy(&header, file_data, sizeof(header));
+    if (std::memcmp(header.magic, baked_font_atlas_magic, 4) != 0 or header.version != baked_font_atlas_version) {
+        release();
+        throw std::runtime_error("not a baked font atlas this version can read, bake it again: " + path);
+    }
+
+    // sizes are checked in 64 bits so a corrupt header can't wrap around past the end of the file
+    std::uint64_t glyphs_end = header.glyphs_offset + std::uint64_t(header.num_glyphs) * sizeof(BakedGlyph);
+    std::uint64_t texels_end = header.texels_offset + std::uint64_t(header.width) * header.height;
+    if (header.glyphs_offset % alignof(BakedGlyph) != 0 or glyphs_end > file_size or texels_end > file_size) {
+        release();
+        throw std::runtime_error("baked font atlas is truncated: " + path);
+    }
+
+    font_size = header.font_size;
+    width = header.width;
+    height = header.height;
+    num_glyphs = header.num_glyphs;
+    glyphs = reinterpret_cast<const BakedGlyph *>(file_data + header.glyphs_offset);
+    texels = file_data + header.texels_offset;
+}
+
+BakedFontAtlas::~BakedFontAtlas() { release(); }
+
+BakedFontAtlas::BakedFontAtlas(BakedFontAtlas &&other) noexcept { *this = std::move(other); }
+
+BakedFontAtlas &BakedFontAtlas::operator=(BakedFontAtlas &&other) noexcept {
+    if (this != &other) {
+        release();
+        // moving the vector keeps its buffer, so the glyph and texel pointers into it stay valid
+        mapping = std::exchange(other.mapping, nullptr);
+        mapping_size = std::exchange(other.mapping_size, 0);
+#ifdef _WIN32
+        file_contents = std::move(other.file_contents);
+#endif
+        font_size = other.font_size;
+        width = other.width;
+        height = other.height;
+        num_glyphs = std::exchange(other.num_glyphs, 0);
+        glyphs = std::exchange(other.glyphs, nullptr);
+        texels = std::exchange(other.texels, nullptr);
+    }
+    return *this;
+}
+
+void BakedFontAtlas::release() {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+        munmap(const_cast<void *>(mapping), mapping_size);
+    }
+#endif
+    mapping = nullptr;
+    mapping_size = 0;
+}
+
+void BakedFontAtlas::write(const std::string &path, int font_size, int width, int height,
+                           const std::vector<BakedGlyph> &glyphs, const std::vector<std::uint8_t> &texels) {
+    if (texels.size() != static_cast<std::size_t>(width) * height) {
+        throw std::runtime_error("baked font atlas texels don't match its size");
+    }
+
+    BakedFontAtlasHeader header;
+    std::memcpy(header.magic, baked_font_atlas_magic, 4);
+    header.version = baked_font_atlas_version;
+    header.font_size = font_size;
+    header.width = width;
+    header.height = height;
+    header.num_glyphs = glyphs.size();
+    header.glyphs_offset = align_to_16(sizeof(header));
+    header.texels_offset = align_to_16(header.glyphs_offset + glyphs.size() * sizeof(BakedGlyph));
+
+    std::vector<std::uint8_t> contents(header.texels_offset + texels.size(), 0);
+    std::memcpy(contents.data(), &header, sizeof(header));
+    std::memcpy(contents.data() + header.glyphs_offset, glyphs.data(), glyphs.size() * sizeof(BakedGlyph));
+    std::memcpy(contents.data() + header.texels_offset, texels.data(), texels.size());
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("unable to open baked font atlas for writing: " + path);
+    }
+    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    written = std::fclose(file) == 0 and written;
+    if (not written) {
+        throw std::runtime_error("unable to write baked font atlas: " + path);
+    }
+}
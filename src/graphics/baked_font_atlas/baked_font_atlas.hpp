@@ -0,0 +1,94 @@
+#ifndef BAKED_FONT_ATLAS_HPP
+#define BAKED_FONT_ATLAS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One glyph of a baked atlas, where it is in the atlas and how it sits on the baseline.
+ *
+ * In texels with y from the bottom of the atlas, x and y are the glyph's bottom left corner. The origin and advance
+ * are the ones in the atlas jsons.
+ */
+struct BakedGlyph {
+    float x;
+    float y;
+    float width;
+    float height;
+    float origin_x;
+    float origin_y;
+    float advance;
+    // 0 for codepoints the atlas has no glyph for
+    std::uint32_t present;
+};
+
+/**
+ * @brief A signed distance field font atlas baked offline into a single file, so loading it is one memory map
+ * rather than json parsing and png decoding.
+ *
+ * The file is a fixed header, a glyph table indexed directly by codepoint and then the distance field, one byte per
+ * texel with the bottom row first so it can be handed to glTexImage2D as is. Glyph lookup is an array index.
+ *
+ * Files are written by tools/font_atlas_baker, the build bakes the atlases in assets/fonts next to the copied
+ * assets.
+ *
+ * @note the file is in the writing machine's byte order, a file from the other byte order is rejected as an
+ * unexpected version.
+ */
+class BakedFontAtlas {
+  public:
+    /**
+     * @throws std::runtime_error if the file is missing or isn't a baked atlas this version can read.
+     */
+    explicit BakedFontAtlas(const std::string &path);
+    ~BakedFontAtlas();
+
+    BakedFontAtlas(BakedFontAtlas &&other) noexcept;
+    BakedFontAtlas &operator=(BakedFontAtlas &&other) noexcept;
+    BakedFontAtlas(const BakedFontAtlas &) = delete;
+    BakedFontAtlas &operator=(const BakedFontAtlas &) = delete;
+
+    /**
+     * @return nullptr if the atlas has no glyph for the codepoint.
+     */
+    const BakedGlyph *get_glyph(std::uint32_t codepoint) const {
+        return codepoint < num_glyphs and glyphs[codepoint].present ? &glyphs[codepoint] : nullptr;
+    }
+
+    int get_font_size() const { return font_size; }
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+
+    /**
+     * @brief The distance field, width * height bytes, bottom row first.
+     */
+    const std::uint8_t *get_texels() const { return texels; }
+
+    /**
+     * @param glyphs indexed by codepoint.
+     * @param texels width * height bytes, bottom row first.
+     * @throws std::runtime_error if the file can't be written.
+     */
+    static void write(const std::string &path, int font_size, int width, int height,
+                      const std::vector<BakedGlyph> &glyphs, const std::vector<std::uint8_t> &texels);
+
+  private:
+    void release();
+
+    const void *mapping = nullptr;
+    std::size_t mapping_size = 0;
+#ifdef _WIN32
+    std::vector<std::uint8_t> file_contents;
+#endif
+
+    int font_size = 0;
+    int width = 0;
+    int height = 0;
+    std::uint32_t num_glyphs = 0;
+    const BakedGlyph *glyphs = nullptr;
+    const std::uint8_t *texels = nullptr;
+};
+
+#endif // BAKED_FONT_ATLAS_HPP
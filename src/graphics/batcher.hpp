@@ -1,212 +1,591 @@
-#ifndef BATCHER_HPP
-#define BATCHER_HPP
-
-#include <vector>
-#include <unordered_map>
-#include <glm/vec3.hpp>
-
-#include <iostream>
-#include "sbpt_generated_includes.hpp"
-
-/**
- * Always buffering data is wasteful for static vertices.
- * E.g., Initially we draw a grid by buffering the vertex positions once at the start of the program
- * but now we have to do that every frame.
- *
- * glBufferSubData
- *
- * In the context of a static object, we are afraid buffering that object's vertices every single frame
- * would be worse than buffering it once. One solution is by using IDs for each object to determine
- * if it has been drawn in the previous frame. If it has, we would come up with a way to make sure we
- * don't have to buffer that data again. We decided not to work on this atm because this will be a
- * complex solution with a lot of changes necessary.
- *
- * queue_draw(id, ...)
- * Map id to vertices in CPU cache
- * For every draw call compare cache with new inputted vertices to see if things changed
- * If yes, then change only those vertices (glBufferSubData)
- * If no, then keep those vertices as is
- * 
- * Newly created vertices should be appended to the list (but this requires either over-allocation at initialization,
- * i.e a bigger buffer than necessary or rebuffering)
- * What about deleted vertices? Problem: they create holes
- * You can use glBufferSubData to shift subsequent elements? Like deleting an element from the middle of a 
- * Python list.
- * 
- * 
- * From Khronos
- * Rendering with a different VAO from the last drawing command is usually a relatively expensive operation.
- * 
- * Shader {
- *   VAO {
- *      VBO-1
- *        VBO-1 attrib-1 enabled/disabled, pointers
- *        VBO-1 attrib-2 enabled/disabled, pointers
- *        ...
- *      VBO-2
- *        ...
- *      VBO-3
- *        ...
- *      (VAO only remembers VBOs if attributes are set up)
- *      ...
- *      EBO (just one; NOT part of global state)
- *   }
- * }
- * 
- * Instance rendering is for when geometry is identical but per-instance attributes vary.
- * Single VBO + per-instance buffers.
- * 
- * Multidraw is for when objects are different but share similar state.
- * Multiple VBOs
- * 
- * Attribute vs. Uniform?
- * Uniforms are shared between all vertices/fragments. Attributes are INTERPOLATED between fragments.
- */
-
-// every shader needs batching unique to it (should every shader implement its own batching?)
-// parse shader to programmatically get attribs and their types while also generating code that batches it
-// is the code that batches it possible to generalize?
-// ShaderVertexAttributeVariable -> vector<ShaderVertexAttributeVariable>
-// vec3attribs = unordered_map<ShaderVertexAttributeVariableEnum, vector<glm::vec3>>
-// uiattribs = unordered_map<ShaderVertexAttributeVariableEnum, vector<unsigned int>>
-// 
-// {ShaderVertexAttributeVariable::POSITION, ShaderVertexAttributeVariable::PASSTHROUGH_RGB_COLOR}
-// for ([attrib, data] : vec3attribs) {
-//    
-// }
-// 
-
-
-struct DrawInfoPerShader {
-    GLuint VAO;
-    GLuint VBO;
-    GLuint CBO;
-    GLuint IBO;
-
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec3> colors;
-    std::vector<unsigned int> indices;
-    // ShaderVertexAttributeVariable -> vector<ShaderVertexAttributeVariable>
-};
-
-// approach 1: 
-// each shader implements its own batching
-// Shader 
-// .draw(..., ..., ...) <-- batching (different args per shader)
-// 
-// approach 2:
-// have all vertices, colors, indices, etc. in function signature of queue_draw but use defaults
-// potentially enable/disable vertex attributes based on which ones the current shader actually needs
-//
-// approach 3:
-// lambda (?) with unique signature per shader
-// like approach 1 without classes
-// shader type -> shader batcher class with function called queue_draw (@override) + relevant info
-// master batcher contains shader type <-> shader batcher
-
-// one problem: we need different signatures based on the shader
-// we don't want to make new functions per shader
-
-// https://www.reddit.com/r/opengl/comments/xtsqoa/optimizing_draw_calls/
-// https://www.reddit.com/r/GraphicsProgramming/comments/qvh62l/comment/hkx35i6/
-
-
-/**
- * approach 1
- * queueDraw = MasterBatcher.shaderBatchers.at(ShaderType::...);
- * queueDraw(..., ..., ...);
- */
-
-
-
-
-
-
-class Batcher {
-  public:
-    Batcher(std::vector<ShaderType> requested_shaders, ShaderCache &shader_cache) : shader_cache{shader_cache} {
-        for (const auto &requested_shader : requested_shaders) {
-            DrawInfoPerShader draw_info{};
-            shader_type_to_draw_info_this_tick[requested_shader] = draw_info;
-
-            glGenVertexArrays(1, &shader_type_to_draw_info_this_tick[requested_shader].VAO);
-
-            // TODO: generalize later
-            glGenBuffers(1, &shader_type_to_draw_info_this_tick[requested_shader].VBO); // For vertices
-            glGenBuffers(1, &shader_type_to_draw_info_this_tick[requested_shader].CBO); // For colors
-            glGenBuffers(1, &shader_type_to_draw_info_this_tick[requested_shader].IBO); // For indices
-
-            glBindVertexArray(shader_type_to_draw_info_this_tick[requested_shader].VAO);
-
-            glBindBuffer(GL_ARRAY_BUFFER, shader_type_to_draw_info_this_tick[requested_shader].VBO);
-
-            // loop?
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-            glEnableVertexAttribArray(0);
-
-            glBindBuffer(GL_ARRAY_BUFFER, shader_type_to_draw_info_this_tick[requested_shader].CBO);
-
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-            glEnableVertexAttribArray(1);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shader_type_to_draw_info_this_tick[requested_shader].IBO);
-
-            glBindVertexArray(0);
-        }
-    }
-
-    void queue_draw(std::vector<glm::vec3> &vertices, std::vector<glm::vec3> &colors,
-                    std::vector<unsigned int> &indices, ShaderType type) {
-        if (shader_type_to_draw_info_this_tick.find(type) == shader_type_to_draw_info_this_tick.end()) {
-            throw std::runtime_error("ShaderType not requested upon initialization!");
-        }
-
-        shader_type_to_draw_info_this_tick[type].vertices.insert(
-            shader_type_to_draw_info_this_tick[type].vertices.end(), vertices.begin(), vertices.end());
-
-        shader_type_to_draw_info_this_tick[type].colors.insert(shader_type_to_draw_info_this_tick[type].colors.end(),
-                                                               colors.begin(), colors.end());
-
-        std::vector<std::vector<unsigned int>> all_indices = {shader_type_to_draw_info_this_tick[type].indices,
-                                                              indices};
-        shader_type_to_draw_info_this_tick[type].indices = flatten_and_increment_indices(all_indices);
-    }
-
-    void draw_everything() {
-        for (const auto &[type, draw_info] : shader_type_to_draw_info_this_tick) {
-            shader_cache.use_shader_program(type);
-
-            glBindVertexArray(draw_info.VAO);
-
-            glBindBuffer(GL_ARRAY_BUFFER, draw_info.VBO);
-            glBufferData(GL_ARRAY_BUFFER, draw_info.vertices.size() * sizeof(glm::vec3), draw_info.vertices.data(),
-                         GL_STATIC_DRAW);
-
-            glBindBuffer(GL_ARRAY_BUFFER, draw_info.CBO);
-            glBufferData(GL_ARRAY_BUFFER, draw_info.colors.size() * sizeof(glm::vec3), draw_info.colors.data(),
-                         GL_STATIC_DRAW);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, draw_info.IBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, draw_info.indices.size() * sizeof(unsigned int),
-                         draw_info.indices.data(), GL_STATIC_DRAW);
-
-            glDrawElements(GL_TRIANGLES, draw_info.indices.size(), GL_UNSIGNED_INT, 0);
-
-            glBindVertexArray(0);
-
-            shader_cache.stop_using_shader_program();
-        }
-
-        for (auto &[type, draw_info] : shader_type_to_draw_info_this_tick) {
-            draw_info.vertices.clear();
-            draw_info.colors.clear();
-            draw_info.indices.clear();
-        }
-    };
-
-  private:
-    std::unordered_map<ShaderType, DrawInfoPerShader> shader_type_to_draw_info_this_tick;
-    ShaderCache shader_cache;
-};
-
-#endif
+#ifndef PERSISTENT_BATCHER_HPP
+#define PERSISTENT_BATCHER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+#include <glm/vec3.hpp>
+
+#include <iostream>
+#include "sbpt_generated_includes.hpp"
+#include "shader_program/shader_program.hpp"
+
+/**
+ * Always buffering data is wasteful for static vertices.
+ * E.g., Initially we draw a grid by buffering the vertex positions once at the start of the program
+ * but now we have to do that every frame.
+ *
+ * glBufferSubData
+ *
+ * In the context of a static object, we are afraid buffering that object's vertices every single frame
+ * would be worse than buffering it once. One solution is by using IDs for each object to determine
+ * if it has been drawn in the previous frame. If it has, we would come up with a way to make sure we
+ * don't have to buffer that data again. This is what queue_draw with an id does, see PersistentDrawInfoPerShader.
+ *
+ * queue_draw(id, ...)
+ * Map id to vertices in CPU cache
+ * For every draw call compare cache with new inputted vertices to see if things changed
+ * If yes, then change only those vertices (glBufferSubData)
+ * If no, then keep those vertices as is
+ * 
+ * Newly created vertices should be appended to the list (but this requires either over-allocation at initialization,
+ * i.e a bigger buffer than necessary or rebuffering)
+ * What about deleted vertices? Problem: they create holes
+ * You can use glBufferSubData to shift subsequent elements? Like deleting an element from the middle of a 
+ * Python list.
+ * 
+ * 
+ * From Khronos
+ * Rendering with a different VAO from the last drawing command is usually a relatively expensive operation.
+ * 
+ * Shader {
+ *   VAO {
+ *      VBO-1
+ *        VBO-1 attrib-1 enabled/disabled, pointers
+ *        VBO-1 attrib-2 enabled/disabled, pointers
+ *        ...
+ *      VBO-2
+ *        ...
+ *      VBO-3
+ *        ...
+ *      (VAO only remembers VBOs if attributes are set up)
+ *      ...
+ *      EBO (just one; NOT part of global state)
+ *   }
+ * }
+ * 
+ * Instance rendering is for when geometry is identical but per-instance attributes vary.
+ * Single VBO + per-instance buffers.
+ * 
+ * Multidraw is for when objects are different but share similar state.
+ * Multiple VBOs
+ * 
+ * Attribute vs. Uniform?
+ * Uniforms are shared between all vertices/fragments. Attributes are INTERPOLATED between fragments.
+ */
+
+// every shader needs batching unique to it (should every shader implement its own batching?)
+// parse shader to programmatically get attribs and their types while also generating code that batches it
+// is the code that batches it possible to generalize?
+// ShaderVertexAttributeVariable -> vector<ShaderVertexAttributeVariable>
+// vec3attribs = unordered_map<ShaderVertexAttributeVariableEnum, vector<glm::vec3>>
+// uiattribs = unordered_map<ShaderVertexAttributeVariableEnum, vector<unsigned int>>
+// 
+// {ShaderVertexAttributeVariable::POSITION, ShaderVertexAttributeVariable::PASSTHROUGH_RGB_COLOR}
+// for ([attrib, data] : vec3attribs) {
+//    
+// }
+// 
+
+
+struct DrawInfoPerShader {
+    GLuint VAO;
+    GLuint VBO;
+    GLuint CBO;
+    GLuint IBO;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> colors;
+    std::vector<unsigned int> indices;
+    // ShaderVertexAttributeVariable -> vector<ShaderVertexAttributeVariable>
+};
+
+// approach 1: 
+// each shader implements its own batching
+// Shader 
+// .draw(..., ..., ...) <-- batching (different args per shader)
+// 
+// approach 2:
+// have all vertices, colors, indices, etc. in function signature of queue_draw but use defaults
+// potentially enable/disable vertex attributes based on which ones the current shader actually needs
+//
+// approach 3:
+// lambda (?) with unique signature per shader
+// like approach 1 without classes
+// shader type -> shader batcher class with function called queue_draw (@override) + relevant info
+// master batcher contains shader type <-> shader batcher
+
+// one problem: we need different signatures based on the shader
+// we don't want to make new functions per shader
+
+// https://www.reddit.com/r/opengl/comments/xtsqoa/optimizing_draw_calls/
+// https://www.reddit.com/r/GraphicsProgramming/comments/qvh62l/comment/hkx35i6/
+
+
+/**
+ * approach 1
+ * queueDraw = MasterBatcher.shaderBatchers.at(ShaderType::...);
+ * queueDraw(..., ..., ...);
+ */
+
+
+
+
+
+
+/**
+ * @brief Hands out ranges of a buffer, reusing the holes left by freed ranges before growing the end.
+ */
+class RangeAllocator {
+  public:
+    std::size_t allocate(std::size_t size) {
+        // first fit, holes are rare enough that anything smarter isn't worth it
+        for (auto it = free_ranges.begin(); it != free_ranges.end(); it++) {
+            if (it->second >= size) {
+                std::size_t offset = it->first;
+                std::size_t remaining = it->second - size;
+                free_ranges.erase(it);
+                if (remaining > 0) {
+                    free_ranges[offset + size] = remaining;
+                }
+                return offset;
+            }
+        }
+        std::size_t offset = end;
+        end += size;
+        return offset;
+    }
+
+    void free(std::size_t offset, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        auto next = free_ranges.lower_bound(offset);
+        if (next != free_ranges.end() and offset + size == next->first) {
+            size += next->second;
+            next = free_ranges.erase(next);
+        }
+        if (next != free_ranges.begin()) {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset) {
+                offset = previous->first;
+                size += previous->second;
+                free_ranges.erase(previous);
+            }
+        }
+
+        if (offset + size == end) {
+            end = offset;
+        } else {
+            free_ranges[offset] = size;
+        }
+    }
+
+    // one past the last range in use, nothing past this needs to be drawn
+    std::size_t get_end() const { return end; }
+
+  private:
+    // offset -> size, adjacent holes are always merged
+    std::map<std::size_t, std::size_t> free_ranges;
+    std::size_t end = 0;
+};
+
+/**
+ * @brief The element ranges of a buffer that changed since it was last uploaded, one per changed object.
+ *
+ * They're only merged right before the upload, so two objects that changed at opposite ends of the buffer are sent
+ * on their own instead of along with every unchanged object in between.
+ */
+class DirtyRanges {
+  public:
+    void mark(std::size_t begin, std::size_t end) {
+        if (begin < end) {
+            ranges.emplace_back(begin, end);
+        }
+    }
+
+    /**
+     * @brief Sorts the ranges and joins the ones that overlap or touch, so nothing is uploaded twice.
+     * @return [begin, end) pairs in buffer order.
+     */
+    const std::vector<std::pair<std::size_t, std::size_t>> &merge() {
+        std::sort(ranges.begin(), ranges.end());
+        std::size_t num_merged = 0;
+        for (std::size_t i = 0; i < ranges.size(); i++) {
+            if (num_merged > 0 and ranges[i].first <= ranges[num_merged - 1].second) {
+                ranges[num_merged - 1].second = std::max(ranges[num_merged - 1].second, ranges[i].second);
+            } else {
+                ranges[num_merged++] = ranges[i];
+            }
+        }
+        ranges.resize(num_merged);
+        return ranges;
+    }
+
+    bool empty() const { return ranges.empty(); }
+    // keeps the capacity, the same objects tend to change again next tick
+    void clear() { ranges.clear(); }
+
+  private:
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+};
+
+struct PersistentObject {
+    std::size_t vertex_offset;
+    std::size_t vertex_capacity;
+    std::size_t vertex_count;
+    std::size_t index_offset;
+    std::size_t index_capacity;
+    std::size_t index_count;
+    bool queued_this_tick;
+};
+
+/**
+ * Buffers for objects queued with an id, they stay on the gpu between ticks.
+ *
+ * The cpu side vectors mirror the whole gpu buffers, including the over-provisioned space past the last object.
+ * Each tick the queued data is compared against the mirror and only the objects that actually changed are uploaded.
+ * Indices are stored already offset into the shared vertex buffer, index slots that aren't in use hold degenerate
+ * triangles so the whole used range can be drawn with one call.
+ */
+struct PersistentDrawInfoPerShader {
+    GLuint VAO;
+    GLuint VBO;
+    GLuint CBO;
+    GLuint IBO;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> colors;
+    std::vector<unsigned int> indices;
+
+    // how much the gpu buffers were last allocated with, in elements
+    std::size_t gpu_vertex_capacity = 0;
+    std::size_t gpu_index_capacity = 0;
+
+    RangeAllocator vertex_allocator;
+    RangeAllocator index_allocator;
+
+    DirtyRanges dirty_vertices;
+    DirtyRanges dirty_colors;
+    DirtyRanges dirty_indices;
+
+    std::unordered_map<unsigned int, PersistentObject> objects;
+};
+
+/**
+ * @brief Batches draws per shader, with objects queued by id kept on the gpu between ticks.
+ *
+ * Builds its own programs through create_shader_program rather than taking them from the shader cache, so they
+ * come out of the program binary cache instead of being compiled from source every launch. Only
+ * ABSOLUTE_POSITION_WITH_COLORED_VERTEX is supported, it's the only shader whose attributes match the vertex and
+ * color buffers here.
+ *
+ * @note named apart from the generated Batcher so both can be used side by side, the generated one for geometry
+ * that changes every tick and this one for geometry that mostly doesn't.
+ */
+class PersistentBatcher {
+  public:
+    explicit PersistentBatcher(std::vector<ShaderType> requested_shaders) {
+        for (const auto &requested_shader : requested_shaders) {
+            shader_type_to_program[requested_shader] = create_program(requested_shader);
+
+            DrawInfoPerShader &draw_info = shader_type_to_draw_info_this_tick[requested_shader];
+            create_vertex_array(draw_info.VAO, draw_info.VBO, draw_info.CBO, draw_info.IBO);
+
+            PersistentDrawInfoPerShader &persistent_draw_info = shader_type_to_persistent_draw_info[requested_shader];
+            create_vertex_array(persistent_draw_info.VAO, persistent_draw_info.VBO, persistent_draw_info.CBO,
+                                persistent_draw_info.IBO);
+        }
+    }
+
+    ~PersistentBatcher() {
+        for (auto &[type, draw_info] : shader_type_to_draw_info_this_tick) {
+            delete_vertex_array(draw_info.VAO, draw_info.VBO, draw_info.CBO, draw_info.IBO);
+        }
+        for (auto &[type, info] : shader_type_to_persistent_draw_info) {
+            delete_vertex_array(info.VAO, info.VBO, info.CBO, info.IBO);
+        }
+        for (auto &[type, program] : shader_type_to_program) {
+            glDeleteProgram(program);
+        }
+    }
+
+    // a copy would delete the same gl objects a second time
+    PersistentBatcher(const PersistentBatcher &) = delete;
+    PersistentBatcher &operator=(const PersistentBatcher &) = delete;
+
+    void queue_draw(const std::vector<glm::vec3> &vertices, const std::vector<glm::vec3> &colors,
+                    const std::vector<unsigned int> &indices, ShaderType type) {
+        if (shader_type_to_draw_info_this_tick.find(type) == shader_type_to_draw_info_this_tick.end()) {
+            throw std::runtime_error("ShaderType not requested upon initialization!");
+        }
+
+        DrawInfoPerShader &draw_info = shader_type_to_draw_info_this_tick[type];
+
+        // the new indices only need to skip past the vertices already in the batch, so appending is linear in the
+        // size of the object and the vectors keep their capacity from one tick to the next
+        unsigned int index_offset = draw_info.vertices.size();
+
+        draw_info.vertices.insert(draw_info.vertices.end(), vertices.begin(), vertices.end());
+        draw_info.colors.insert(draw_info.colors.end(), colors.begin(), colors.end());
+
+        for (unsigned int index : indices) {
+            draw_info.indices.push_back(index_offset + index);
+        }
+    }
+
+    /**
+     * @brief Queues an object that is expected to be drawn again on the next tick.
+     *
+     * The object's vertices are kept on the gpu between ticks and only re-uploaded when they differ from what was
+     * queued with the same id last time. Objects that aren't queued during a tick are removed when it is drawn,
+     * and the space they leave behind is reused by later objects.
+     *
+     * @note indices are local to the object, the same as with the id-less overload.
+     */
+    void queue_draw(unsigned int id, const std::vector<glm::vec3> &vertices, const std::vector<glm::vec3> &colors,
+                    const std::vector<unsigned int> &indices, ShaderType type) {
+        auto info_it = shader_type_to_persistent_draw_info.find(type);
+        if (info_it == shader_type_to_persistent_draw_info.end()) {
+            throw std::runtime_error("ShaderType not requested upon initialization!");
+        }
+        PersistentDrawInfoPerShader &info = info_it->second;
+
+        auto [object_it, is_new] = info.objects.try_emplace(id);
+        PersistentObject &object = object_it->second;
+
+        // set whenever the object's ranges moved, everything has to be written out again
+        bool needs_full_write = is_new or vertices.size() > object.vertex_capacity;
+        if (needs_full_write) {
+            if (not is_new) {
+                info.vertex_allocator.free(object.vertex_offset, object.vertex_capacity);
+            }
+            object.vertex_capacity = vertices.size();
+            object.vertex_offset = info.vertex_allocator.allocate(object.vertex_capacity);
+            reserve_persistent_vertices(info);
+        }
+
+        if (is_new or indices.size() > object.index_capacity) {
+            if (not is_new) {
+                free_persistent_indices(info, object.index_offset, object.index_capacity);
+            }
+            object.index_capacity = indices.size();
+            object.index_offset = info.index_allocator.allocate(object.index_capacity);
+            reserve_persistent_indices(info);
+            needs_full_write = true;
+        }
+
+        object.vertex_count = vertices.size();
+        object.index_count = indices.size();
+        object.queued_this_tick = true;
+
+        auto vertices_begin = info.vertices.begin() + object.vertex_offset;
+        if (needs_full_write or not std::equal(vertices.begin(), vertices.end(), vertices_begin)) {
+            std::copy(vertices.begin(), vertices.end(), vertices_begin);
+            info.dirty_vertices.mark(object.vertex_offset, object.vertex_offset + vertices.size());
+        }
+
+        std::size_t num_colors = std::min(colors.size(), vertices.size());
+        auto colors_begin = info.colors.begin() + object.vertex_offset;
+        if (needs_full_write or not std::equal(colors.begin(), colors.begin() + num_colors, colors_begin)) {
+            std::copy(colors.begin(), colors.begin() + num_colors, colors_begin);
+            info.dirty_colors.mark(object.vertex_offset, object.vertex_offset + num_colors);
+        }
+
+        bool indices_changed = needs_full_write;
+        for (std::size_t i = 0; i < object.index_capacity and not indices_changed; i++) {
+            unsigned int expected = i < indices.size() ? object.vertex_offset + indices[i] : 0;
+            indices_changed = info.indices[object.index_offset + i] != expected;
+        }
+        if (indices_changed) {
+            for (std::size_t i = 0; i < object.index_capacity; i++) {
+                // leftover slots from a bigger earlier version of the object become degenerate triangles
+                info.indices[object.index_offset + i] = i < indices.size() ? object.vertex_offset + indices[i] : 0;
+            }
+            info.dirty_indices.mark(object.index_offset, object.index_offset + object.index_capacity);
+        }
+    }
+
+    void draw_everything() {
+        for (auto &[type, info] : shader_type_to_persistent_draw_info) {
+            remove_objects_not_queued_this_tick(info);
+            upload_persistent_changes(info);
+
+            if (info.index_allocator.get_end() == 0) {
+                continue;
+            }
+            glUseProgram(shader_type_to_program.at(type));
+            glBindVertexArray(info.VAO);
+            glDrawElements(GL_TRIANGLES, info.index_allocator.get_end(), GL_UNSIGNED_INT, 0);
+            glBindVertexArray(0);
+            glUseProgram(0);
+        }
+
+        for (const auto &[type, draw_info] : shader_type_to_draw_info_this_tick) {
+            if (draw_info.indices.empty()) {
+                continue;
+            }
+            glUseProgram(shader_type_to_program.at(type));
+
+            glBindVertexArray(draw_info.VAO);
+
+            glBindBuffer(GL_ARRAY_BUFFER, draw_info.VBO);
+            glBufferData(GL_ARRAY_BUFFER, draw_info.vertices.size() * sizeof(glm::vec3), draw_info.vertices.data(),
+                         GL_STATIC_DRAW);
+
+            glBindBuffer(GL_ARRAY_BUFFER, draw_info.CBO);
+            glBufferData(GL_ARRAY_BUFFER, draw_info.colors.size() * sizeof(glm::vec3), draw_info.colors.data(),
+                         GL_STATIC_DRAW);
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, draw_info.IBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, draw_info.indices.size() * sizeof(unsigned int),
+                         draw_info.indices.data(), GL_STATIC_DRAW);
+
+            glDrawElements(GL_TRIANGLES, draw_info.indices.size(), GL_UNSIGNED_INT, 0);
+
+            glBindVertexArray(0);
+
+            glUseProgram(0);
+        }
+
+        for (auto &[type, draw_info] : shader_type_to_draw_info_this_tick) {
+            draw_info.vertices.clear();
+            draw_info.colors.clear();
+            draw_info.indices.clear();
+        }
+    };
+
+  private:
+    static GLuint create_program(ShaderType type) {
+        if (type != ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX) {
+            throw std::runtime_error("PersistentBatcher only supports ABSOLUTE_POSITION_WITH_COLORED_VERTEX");
+        }
+        const char *vertex_shader_source = R"glsl(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 passthrough_rgb_color;
+
+out vec3 rgb_color;
+
+void main() {
+    gl_Position = vec4(position, 1.0);
+    rgb_color = passthrough_rgb_color;
+}
+)glsl";
+        const char *fragment_shader_source = R"glsl(
+#version 330 core
+
+in vec3 rgb_color;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = vec4(rgb_color, 1.0);
+}
+)glsl";
+        return create_shader_program("absolute position with colored vertex", vertex_shader_source,
+                                     fragment_shader_source);
+    }
+
+    static void create_vertex_array(GLuint &VAO, GLuint &VBO, GLuint &CBO, GLuint &IBO) {
+        glGenVertexArrays(1, &VAO);
+
+        // TODO: generalize later
+        glGenBuffers(1, &VBO); // For vertices
+        glGenBuffers(1, &CBO); // For colors
+        glGenBuffers(1, &IBO); // For indices
+
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        // loop?
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, CBO);
+
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(1);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+
+        glBindVertexArray(0);
+    }
+
+    static void delete_vertex_array(GLuint VAO, GLuint VBO, GLuint CBO, GLuint IBO) {
+        glDeleteVertexArrays(1, &VAO);
+        GLuint buffers[] = {VBO, CBO, IBO};
+        glDeleteBuffers(3, buffers);
+    }
+
+    // the mirrors grow geometrically so adding objects one at a time doesn't reallocate the gpu buffers every tick
+    static std::size_t grown_capacity(std::size_t current_capacity, std::size_t required_capacity) {
+        return std::max({required_capacity, current_capacity * 2, std::size_t(1024)});
+    }
+
+    static void reserve_persistent_vertices(PersistentDrawInfoPerShader &info) {
+        std::size_t required = info.vertex_allocator.get_end();
+        if (required > info.vertices.size()) {
+            std::size_t capacity = grown_capacity(info.vertices.size(), required);
+            info.vertices.resize(capacity);
+            info.colors.resize(capacity);
+        }
+    }
+
+    static void reserve_persistent_indices(PersistentDrawInfoPerShader &info) {
+        std::size_t required = info.index_allocator.get_end();
+        if (required > info.indices.size()) {
+            info.indices.resize(grown_capacity(info.indices.size(), required), 0);
+        }
+    }
+
+    static void free_persistent_indices(PersistentDrawInfoPerShader &info, std::size_t offset, std::size_t count) {
+        std::fill(info.indices.begin() + offset, info.indices.begin() + offset + count, 0);
+        info.dirty_indices.mark(offset, offset + count);
+        info.index_allocator.free(offset, count);
+    }
+
+    static void remove_objects_not_queued_this_tick(PersistentDrawInfoPerShader &info) {
+        for (auto it = info.objects.begin(); it != info.objects.end();) {
+            PersistentObject &object = it->second;
+            if (object.queued_this_tick) {
+                object.queued_this_tick = false;
+                it++;
+                continue;
+            }
+            info.vertex_allocator.free(object.vertex_offset, object.vertex_capacity);
+            free_persistent_indices(info, object.index_offset, object.index_capacity);
+            it = info.objects.erase(it);
+        }
+    }
+
+    template <typename T>
+    static void upload_range(GLenum target, GLuint buffer, const std::vector<T> &mirror, std::size_t &gpu_capacity,
+                             DirtyRanges &dirty_ranges) {
+        glBindBuffer(target, buffer);
+        if (mirror.size() > gpu_capacity) {
+            // the mirror outgrew the gpu buffer, reallocate it with all of the over-provisioned space
+            glBufferData(target, mirror.size() * sizeof(T), mirror.data(), GL_DYNAMIC_DRAW);
+            gpu_capacity = mirror.size();
+        } else if (not dirty_ranges.empty()) {
+            for (const auto &[begin, end] : dirty_ranges.merge()) {
+                std::size_t count = std::min(end, mirror.size()) - begin;
+                glBufferSubData(target, begin * sizeof(T), count * sizeof(T), mirror.data() + begin);
+            }
+        }
+        dirty_ranges.clear();
+    }
+
+    void upload_persistent_changes(PersistentDrawInfoPerShader &info) {
+        // element array bindings are vao state, so bind the vao before touching the ibo
+        glBindVertexArray(info.VAO);
+        std::size_t gpu_vertex_capacity = info.gpu_vertex_capacity;
+        upload_range(GL_ARRAY_BUFFER, info.VBO, info.vertices, info.gpu_vertex_capacity, info.dirty_vertices);
+        // vertices and colors always grow together so the colors share the vertex capacity
+        upload_range(GL_ARRAY_BUFFER, info.CBO, info.colors, gpu_vertex_capacity, info.dirty_colors);
+        upload_range(GL_ELEMENT_ARRAY_BUFFER, info.IBO, info.indices, info.gpu_index_capacity, info.dirty_indices);
+        glBindVertexArray(0);
+    }
+
+    std::unordered_map<ShaderType, DrawInfoPerShader> shader_type_to_draw_info_this_tick;
+    std::unordered_map<ShaderType, PersistentDrawInfoPerShader> shader_type_to_persistent_draw_info;
+    std::unordered_map<ShaderType, GLuint> shader_type_to_program;
+};
+
+#endif // PERSISTENT_BATCHER_HPP
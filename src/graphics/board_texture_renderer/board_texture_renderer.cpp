@@ -0,0 +1,328 @@
+#include "board_texture_renderer.hpp"
+#include "../shader_program/shader_program.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+enum CellState : std::uint8_t { UNREVEALED = 0, REVEALED = 1, FLAGGED = 2, SAFE_START = 3 };
+
+// in the order the shader indexes glyph_rects
+const std::array<char, 10> glyph_labels = {'1', '2', '3', '4', '5', '6', '7', '8', 'F', 'X'};
+
+const float character_width = 0.5;
+const float edge_transition_width = 0.1;
+
+const char *vertex_shader_source = R"glsl(
+#version 330 core
+
+// the board is a single quad, its corners come from the vertex id so there is no vertex buffer
+uniform vec2 board_min;
+uniform vec2 board_max;
+
+out vec2 ndc_position;
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    ndc_position = mix(board_min, board_max, corner);
+    gl_Position = vec4(ndc_position, 0.0, 1.0);
+}
+)glsl";
+
+const char *fragment_shader_source = R"glsl(
+#version 330 core
+
+const int UNREVEALED = 0;
+const int REVEALED = 1;
+const int FLAGGED = 2;
+const int SAFE_START = 3;
+
+// glyph_rects holds "1" to "8" followed by these
+const int FLAG_GLYPH = 8;
+const int SAFE_START_GLYPH = 9;
+
+in vec2 ndc_position;
+
+out vec4 frag_color;
+
+// one texel per cell, red is the cell state and green the adjacent mine count
+uniform sampler2D cell_states;
+uniform ivec2 board_size;
+
+// the outer corner of cell (0, 0), pitch is signed so rows can go down the screen
+uniform vec2 grid_origin;
+uniform vec2 cell_pitch;
+uniform vec2 cell_size;
+uniform vec2 cell_size_in_pixels;
+
+uniform vec3 count_colors[9];
+uniform vec3 unrevealed_color;
+uniform vec3 flagged_color;
+uniform vec3 safe_start_color;
+uniform vec3 text_color;
+
+uniform sampler2D font_atlas;
+uniform vec2 font_atlas_size;
+// x, y, width, height in texture coordinates
+uniform vec4 glyph_rects[10];
+uniform float character_width;
+uniform float edge_transition_width;
+
+void main() {
+    ivec2 cell = ivec2(floor((ndc_position - grid_origin) / cell_pitch));
+    if (any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, board_size))) {
+        discard;
+    }
+
+    // position inside the cell from its bottom left corner, anything outside is the spacing between cells
+    vec2 cell_center = grid_origin + (vec2(cell) + 0.5) * cell_pitch;
+    vec2 in_cell = (ndc_position - cell_center) / cell_size + 0.5;
+    if (any(lessThan(in_cell, vec2(0.0))) || any(greaterThan(in_cell, vec2(1.0)))) {
+        discard;
+    }
+
+    vec2 state = texelFetch(cell_states, cell, 0).rg * 255.0;
+    int cell_state = int(state.r + 0.5);
+    int adjacent_mines = int(state.g + 0.5);
+
+    vec3 color = unrevealed_color;
+    int glyph = -1;
+    if (cell_state == REVEALED) {
+        color = count_colors[adjacent_mines];
+        glyph = adjacent_mines - 1;
+    } else if (cell_state == FLAGGED) {
+        color = flagged_color;
+        glyph = FLAG_GLYPH;
+    } else if (cell_state == SAFE_START) {
+        color = safe_start_color;
+        glyph = SAFE_START_GLYPH;
+    }
+
+    if (glyph >= 0) {
+        vec4 glyph_rect = glyph_rects[glyph];
+        vec2 glyph_size_in_pixels = glyph_rect.zw * font_atlas_size;
+        // same as the per cell text, the glyph fits in the middle half of the cell without stretching
+        float scale = min(0.5 * cell_size_in_pixels.x / glyph_size_in_pixels.x,
+                          0.5 * cell_size_in_pixels.y / glyph_size_in_pixels.y);
+        vec2 glyph_extent = glyph_size_in_pixels * scale / cell_size_in_pixels;
+        vec2 glyph_uv = (in_cell - 0.5) / glyph_extent + 0.5;
+
+        if (all(greaterThanEqual(glyph_uv, vec2(0.0))) && all(lessThanEqual(glyph_uv, vec2(1.0)))) {
+            float distance = texture(font_atlas, glyph_rect.xy + glyph_uv * glyph_rect.zw).r;
+            float alpha = 1.0 - smoothstep(character_width, character_width + edge_transition_width, 1.0 - distance);
+            color = mix(color, text_color, alpha);
+        }
+    }
+
+    frag_color = vec4(color, 1.0);
+}
+)glsl";
+
+} // namespace
+
+BoardTextureRenderer::BoardTextureRenderer(const BakedFontAtlas &font_atlas) {
+    std::array<float, 4 * glyph_labels.size()> glyph_rects;
+    for (std::size_t i = 0; i < glyph_labels.size(); i++) {
+        const BakedGlyph *glyph = font_atlas.get_glyph(glyph_labels[i]);
+        if (glyph == nullptr) {
+            throw std::runtime_error(std::string("font atlas has no glyph for ") + glyph_labels[i]);
+        }
+        glyph_rects[4 * i + 0] = glyph->x / font_atlas.get_width();
+        glyph_rects[4 * i + 1] = glyph->y / font_atlas.get_height();
+        glyph_rects[4 * i + 2] = glyph->width / font_atlas.get_width();
+        glyph_rects[4 * i + 3] = glyph->height / font_atlas.get_height();
+    }
+
+    shader_program = create_shader_program("board texture", vertex_shader_source, fragment_shader_source);
+
+    // the baked texels are already bottom row first, which is what the glyph rects' y is measured from, and are
+    // only the distance, so they go up as they are
+    glGenTextures(1, &font_atlas_texture);
+    glBindTexture(GL_TEXTURE_2D, font_atlas_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, font_atlas.get_width(), font_atlas.get_height(), 0, GL_RED,
+                 GL_UNSIGNED_BYTE, font_atlas.get_texels());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenTextures(1, &cell_state_texture);
+    glBindTexture(GL_TEXTURE_2D, cell_state_texture);
+    // the shader fetches exact texels, so filtering never comes into play
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &VAO);
+
+    board_min_location = glGetUniformLocation(shader_program, "board_min");
+    board_max_location = glGetUniformLocation(shader_program, "board_max");
+    board_size_location = glGetUniformLocation(shader_program, "board_size");
+    grid_origin_location = glGetUniformLocation(shader_program, "grid_origin");
+    cell_pitch_location = glGetUniformLocation(shader_program, "cell_pitch");
+    cell_size_location = glGetUniformLocation(shader_program, "cell_size");
+    cell_size_in_pixels_location = glGetUniformLocation(shader_program, "cell_size_in_pixels");
+
+    glUseProgram(shader_program);
+    glUniform1i(glGetUniformLocation(shader_program, "cell_states"), 0);
+    glUniform1i(glGetUniformLocation(shader_program, "font_atlas"), 1);
+    glUniform2f(glGetUniformLocation(shader_program, "font_atlas_size"), font_atlas.get_width(),
+                font_atlas.get_height());
+    glUniform4fv(glGetUniformLocation(shader_program, "glyph_rects"), glyph_labels.size(), glyph_rects.data());
+    glUniform1f(glGetUniformLocation(shader_program, "character_width"), character_width);
+    glUniform1f(glGetUniformLocation(shader_program, "edge_transition_width"), edge_transition_width);
+    glUseProgram(0);
+}
+
+BoardTextureRenderer::~BoardTextureRenderer() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteTextures(1, &cell_state_texture);
+    glDeleteTextures(1, &font_atlas_texture);
+    glDeleteProgram(shader_program);
+}
+
+void BoardTextureRenderer::set_colors(const std::array<glm::vec3, 9> &count_colors, const glm::vec3 &unrevealed_color,
+                                      const glm::vec3 &flagged_color, const glm::vec3 &safe_start_color,
+                                      const glm::vec3 &text_color) {
+    glUseProgram(shader_program);
+    glUniform3fv(glGetUniformLocation(shader_program, "count_colors"), count_colors.size(), &count_colors[0].x);
+    glUniform3f(glGetUniformLocation(shader_program, "unrevealed_color"), unrevealed_color.x, unrevealed_color.y,
+                unrevealed_color.z);
+    glUniform3f(glGetUniformLocation(shader_program, "flagged_color"), flagged_color.x, flagged_color.y,
+                flagged_color.z);
+    glUniform3f(glGetUniformLocation(shader_program, "safe_start_color"), safe_start_color.x, safe_start_color.y,
+                safe_start_color.z);
+    glUniform3f(glGetUniformLocation(shader_program, "text_color"), text_color.x, text_color.y, text_color.z);
+    glUseProgram(0);
+}
+
+void BoardTextureRenderer::set_layout(const GridLayout &grid_layout) {
+    cell_pitch = grid_layout.cell_pitch;
+    cell_size = grid_layout.cell_size;
+    grid_origin = grid_layout.first_cell_center - cell_pitch * 0.5f;
+}
+
+std::array<std::uint8_t, 2> BoardTextureRenderer::compute_texel(const FlatBoard &board, int row, int col) const {
+    std::uint8_t adjacent_mines = board.get_adjacent_mines(row, col);
+    if (board.is_revealed(row, col)) {
+        return {REVEALED, adjacent_mines};
+    }
+    if (board.is_flagged(row, col)) {
+        return {FLAGGED, adjacent_mines};
+    }
+    if (board.is_safe_start(row, col)) {
+        return {SAFE_START, adjacent_mines};
+    }
+    return {UNREVEALED, adjacent_mines};
+}
+
+void BoardTextureRenderer::write_texel(const FlatBoard &board, int row, int col) {
+    auto texel = compute_texel(board, row, col);
+    std::size_t offset = 2 * (static_cast<std::size_t>(row) * texture_width + col);
+    if (texels[offset] == texel[0] and texels[offset + 1] == texel[1]) {
+        return;
+    }
+    texels[offset] = texel[0];
+    texels[offset + 1] = texel[1];
+    dirty_min_row = std::min(dirty_min_row, row);
+    dirty_max_row = std::max(dirty_max_row, row);
+    dirty_min_col = std::min(dirty_min_col, col);
+    dirty_max_col = std::max(dirty_max_col, col);
+}
+
+void BoardTextureRenderer::update(const FlatBoard &board) {
+    dirty_min_row = board.num_cells_y;
+    dirty_max_row = -1;
+    dirty_min_col = board.num_cells_x;
+    dirty_max_col = -1;
+
+    // only the cells under changed bits need a new texel
+    BoardChange change = uploaded_board.sync(board, [&](std::size_t word_index, std::uint64_t changed) {
+        int row = word_index / board.words_per_row;
+        int first_col = (word_index % board.words_per_row) * 64;
+        for (; changed != 0; changed &= changed - 1) {
+            int bit = 0;
+            while (not((changed >> bit) & 1)) {
+                bit++;
+            }
+            write_texel(board, row, first_col + bit);
+        }
+    });
+    if (change == BoardChange::NONE or (change == BoardChange::CELLS and dirty_max_row < 0)) {
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, cell_state_texture);
+    // rows are two bytes per texel, which usually isn't four byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (change == BoardChange::NEW_BOARD) {
+        bool resized = board.num_cells_x != texture_width or board.num_cells_y != texture_height;
+        texture_width = board.num_cells_x;
+        texture_height = board.num_cells_y;
+        texels.resize(2 * static_cast<std::size_t>(texture_width) * texture_height);
+        for (int row = 0; row < texture_height; row++) {
+            for (int col = 0; col < texture_width; col++) {
+                auto texel = compute_texel(board, row, col);
+                std::size_t offset = 2 * (static_cast<std::size_t>(row) * texture_width + col);
+                texels[offset] = texel[0];
+                texels[offset + 1] = texel[1];
+            }
+        }
+
+        if (resized) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, texture_width, texture_height, 0, GL_RG, GL_UNSIGNED_BYTE,
+                         texels.data());
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture_width, texture_height, GL_RG, GL_UNSIGNED_BYTE,
+                            texels.data());
+        }
+    } else {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, texture_width);
+        std::size_t offset = 2 * (static_cast<std::size_t>(dirty_min_row) * texture_width + dirty_min_col);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, dirty_min_col, dirty_min_row, dirty_max_col - dirty_min_col + 1,
+                        dirty_max_row - dirty_min_row + 1, GL_RG, GL_UNSIGNED_BYTE, texels.data() + offset);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void BoardTextureRenderer::draw(int screen_width, int screen_height) {
+    if (texture_width == 0 or texture_height == 0) {
+        return;
+    }
+
+    glm::vec2 far_corner = grid_origin + cell_pitch * glm::vec2(texture_width, texture_height);
+    glm::vec2 board_min(std::min(grid_origin.x, far_corner.x), std::min(grid_origin.y, far_corner.y));
+    glm::vec2 board_max(std::max(grid_origin.x, far_corner.x), std::max(grid_origin.y, far_corner.y));
+
+    glUseProgram(shader_program);
+    glUniform2f(board_min_location, board_min.x, board_min.y);
+    glUniform2f(board_max_location, board_max.x, board_max.y);
+    glUniform2i(board_size_location, texture_width, texture_height);
+    glUniform2f(grid_origin_location, grid_origin.x, grid_origin.y);
+    glUniform2f(cell_pitch_location, cell_pitch.x, cell_pitch.y);
+    glUniform2f(cell_size_location, cell_size.x, cell_size.y);
+    // ndc spans two units across the screen
+    glUniform2f(cell_size_in_pixels_location, cell_size.x * screen_width * 0.5f,
+                cell_size.y * screen_height * 0.5f);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, cell_state_texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, font_atlas_texture);
+
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
@@ -0,0 +1,90 @@
+#ifndef BOARD_TEXTURE_RENDERER_HPP
+#define BOARD_TEXTURE_RENDERER_HPP
+
+#include <array>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <string>
+#include <vector>
+
+#include "../../flat_board/board_change_tracker.hpp"
+#include "../../flat_board/flat_board.hpp"
+#include "../baked_font_atlas/baked_font_atlas.hpp"
+#include "../grid_layout/grid_layout.hpp"
+
+/**
+ * @brief Draws the whole minefield as one quad, for boards too big for per cell geometry.
+ *
+ * The state of every cell lives in a small RG8 texture with one texel per cell, and the fragment shader works out
+ * which cell it is in, picks the cell color and stamps the label glyph straight out of the signed distance field
+ * font atlas. The cost of drawing doesn't depend on the board size, and after a move only the texels that changed
+ * are uploaded.
+ */
+class BoardTextureRenderer {
+  public:
+    /**
+     * @param font_atlas the label glyphs are stamped from it, it's uploaded so it doesn't have to outlive this.
+     */
+    explicit BoardTextureRenderer(const BakedFontAtlas &font_atlas);
+    ~BoardTextureRenderer();
+
+    BoardTextureRenderer(const BoardTextureRenderer &) = delete;
+    BoardTextureRenderer &operator=(const BoardTextureRenderer &) = delete;
+
+    /**
+     * @param count_colors revealed cell colors indexed by adjacent mine count.
+     */
+    void set_colors(const std::array<glm::vec3, 9> &count_colors, const glm::vec3 &unrevealed_color,
+                    const glm::vec3 &flagged_color, const glm::vec3 &safe_start_color, const glm::vec3 &text_color);
+
+    void set_layout(const GridLayout &grid_layout);
+
+    /**
+     * @brief Brings the state texture in line with the board.
+     *
+     * A new board (different size, mines or safe start) is uploaded whole, otherwise only the bounding box of the
+     * cells whose revealed or flagged bit changed is. Does nothing if the board hasn't changed since the last call.
+     */
+    void update(const FlatBoard &board);
+
+    /**
+     * @brief The screen size is the framebuffer's in pixels, not the window's, the two differ on high dpi displays
+     * and the label edges are smoothed over real pixels.
+     */
+    void draw(int screen_width, int screen_height);
+
+  private:
+    std::array<std::uint8_t, 2> compute_texel(const FlatBoard &board, int row, int col) const;
+    void write_texel(const FlatBoard &board, int row, int col);
+
+    GLuint shader_program;
+    // nothing is stored in it, core profiles just need one bound to draw
+    GLuint VAO;
+    GLuint cell_state_texture;
+    GLuint font_atlas_texture;
+
+    // set every draw, so looked up once
+    GLint board_min_location;
+    GLint board_max_location;
+    GLint board_size_location;
+    GLint grid_origin_location;
+    GLint cell_pitch_location;
+    GLint cell_size_location;
+    GLint cell_size_in_pixels_location;
+
+    glm::vec2 grid_origin{0};
+    glm::vec2 cell_pitch{1};
+    glm::vec2 cell_size{1};
+
+    // what the state texture currently holds
+    int texture_width = 0;
+    int texture_height = 0;
+    std::vector<std::uint8_t> texels;
+    BoardChangeTracker uploaded_board;
+
+    int dirty_min_row, dirty_max_row, dirty_min_col, dirty_max_col;
+};
+
+#endif // BOARD_TEXTURE_RENDERER_HPP
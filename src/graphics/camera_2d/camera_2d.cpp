@@ -0,0 +1,51 @@
+#include "camera_2d.hpp"
+
+#include <algorithm>
+
+void Camera2D::set_zoom_limits(float min_zoom, float max_zoom) {
+    this->min_zoom = min_zoom;
+    this->max_zoom = std::max(min_zoom, max_zoom);
+    zoom = std::clamp(zoom, this->min_zoom, this->max_zoom);
+}
+
+void Camera2D::reset() {
+    center = glm::vec2(0);
+    zoom = std::clamp(1.0f, min_zoom, max_zoom);
+}
+
+glm::vec2 Camera2D::world_to_ndc(const glm::vec2 &world_position) const {
+    return glm::vec2((world_position.x - center.x) * zoom / aspect_ratio, (world_position.y - center.y) * zoom);
+}
+
+glm::vec2 Camera2D::ndc_to_world(const glm::vec2 &ndc_position) const {
+    return glm::vec2(ndc_position.x * aspect_ratio / zoom + center.x, ndc_position.y / zoom + center.y);
+}
+
+void Camera2D::pan_by_ndc(const glm::vec2 &ndc_delta) {
+    center.x -= ndc_delta.x * aspect_ratio / zoom;
+    center.y -= ndc_delta.y / zoom;
+    clamp_center();
+}
+
+void Camera2D::zoom_about(const glm::vec2 &ndc_position, float factor) {
+    glm::vec2 world_under_position = ndc_to_world(ndc_position);
+    zoom = std::clamp(zoom * factor, min_zoom, max_zoom);
+    // solve world_to_ndc(world_under_position) == ndc_position for the center
+    center.x = world_under_position.x - ndc_position.x * aspect_ratio / zoom;
+    center.y = world_under_position.y - ndc_position.y / zoom;
+    clamp_center();
+}
+
+GridLayout Camera2D::world_to_ndc(const GridLayout &world_layout) const {
+    GridLayout ndc_layout = world_layout;
+    glm::vec2 scale(zoom / aspect_ratio, zoom);
+    ndc_layout.first_cell_center = world_to_ndc(world_layout.first_cell_center);
+    ndc_layout.cell_pitch = world_layout.cell_pitch * scale;
+    ndc_layout.cell_size = world_layout.cell_size * scale;
+    return ndc_layout;
+}
+
+void Camera2D::clamp_center() {
+    center.x = std::clamp(center.x, -1.0f, 1.0f);
+    center.y = std::clamp(center.y, -1.0f, 1.0f);
+}
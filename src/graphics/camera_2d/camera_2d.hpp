@@ -0,0 +1,59 @@
+#ifndef CAMERA_2D_HPP
+#define CAMERA_2D_HPP
+
+#include <glm/vec2.hpp>
+
+#include "../grid_layout/grid_layout.hpp"
+
+/**
+ * @brief Pan and zoom over a world whose interesting part is the square from (-1, -1) to (1, 1).
+ *
+ * At zoom 1 with the camera centered that square fills the height of the screen, and the x axis is scaled by the
+ * aspect ratio so world units are square on screen whatever the window's shape.
+ */
+class Camera2D {
+  public:
+    /**
+     * @param max_zoom how far in the camera may go, at zoom z a world unit spans z half screens vertically.
+     */
+    void set_zoom_limits(float min_zoom, float max_zoom);
+    void set_aspect_ratio(float aspect_ratio) { this->aspect_ratio = aspect_ratio; }
+
+    /**
+     * @brief Back to showing the whole world square.
+     */
+    void reset();
+
+    glm::vec2 world_to_ndc(const glm::vec2 &world_position) const;
+    glm::vec2 ndc_to_world(const glm::vec2 &ndc_position) const;
+
+    /**
+     * @brief Moves the view so whatever was under one screen position ends up under another, a mouse drag from
+     * the previous position to the current one moves the world along with the mouse.
+     */
+    void pan_by_ndc(const glm::vec2 &ndc_delta);
+
+    /**
+     * @brief Multiplies the zoom while keeping the world position under the given screen position in place.
+     */
+    void zoom_about(const glm::vec2 &ndc_position, float factor);
+
+    /**
+     * @brief The same grid as seen through the camera, for drawing and hit testing in NDC.
+     */
+    GridLayout world_to_ndc(const GridLayout &world_layout) const;
+
+    float get_zoom() const { return zoom; }
+
+  private:
+    // the center can't leave the world square, so the board can't be lost off screen
+    void clamp_center();
+
+    glm::vec2 center{0};
+    float zoom = 1;
+    float min_zoom = 1;
+    float max_zoom = 1;
+    float aspect_ratio = 1;
+};
+
+#endif // CAMERA_2D_HPP
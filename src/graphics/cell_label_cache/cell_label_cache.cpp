@@ -0,0 +1,27 @@
+#include "cell_label_cache.hpp"
+
+#include <string>
+
+void CellLabelCache::set_label_size(float width, float height) {
+    if (not label_meshes.empty() and width == label_width and height == label_height) {
+        return;
+    }
+    label_width = width;
+    label_height = height;
+
+    // in label order, the counts first and then FLAG_LABEL and SAFE_START_LABEL
+    const std::string labels[] = {"1", "2", "3", "4", "5", "6", "7", "8", "F", "X"};
+    label_meshes.clear();
+    for (const auto &label : labels) {
+        label_meshes.push_back(font.generate_text_mesh_size_constraints(label, 0, 0, width, height));
+    }
+}
+
+std::vector<glm::vec3> &CellLabelCache::get_positions_at(int label, float x, float y) {
+    const std::vector<glm::vec3> &positions = label_meshes[label].vertex_positions;
+    translated_positions.resize(positions.size());
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        translated_positions[i] = glm::vec3(positions[i].x + x, positions[i].y + y, positions[i].z);
+    }
+    return translated_positions;
+}
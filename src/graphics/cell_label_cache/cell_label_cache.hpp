@@ -0,0 +1,45 @@
+#ifndef CELL_LABEL_CACHE_HPP
+#define CELL_LABEL_CACHE_HPP
+
+#include <glm/vec3.hpp>
+#include <vector>
+
+#include "../sdf_font/sdf_font.hpp"
+
+/**
+ * @brief Text meshes for every label a cell can show, laid out once instead of per cell per frame.
+ *
+ * A cell only ever shows "1" to "8", "F" or "X", and every cell on a board is the same size, so each label is laid
+ * out once centered on the origin and drawing it on a cell is just an offset of its vertex positions. Laying a label
+ * out only indexes the font's baked glyph table.
+ */
+class CellLabelCache {
+  public:
+    static constexpr int FLAG_LABEL = 8;
+    static constexpr int SAFE_START_LABEL = 9;
+    static int get_count_label(int adjacent_mines) { return adjacent_mines - 1; }
+
+    explicit CellLabelCache(const SDFFont &font) : font(font) {}
+
+    /**
+     * @brief Sets the box every label is fit into, the labels are only laid out again if it changed.
+     */
+    void set_label_size(float width, float height);
+
+    SDFTextMesh &get_mesh(int label) { return label_meshes[label]; }
+
+    /**
+     * @brief The label's vertex positions moved to be centered on (x, y).
+     * @note the returned vector is reused by the next call.
+     */
+    std::vector<glm::vec3> &get_positions_at(int label, float x, float y);
+
+  private:
+    const SDFFont &font;
+    std::vector<SDFTextMesh> label_meshes;
+    float label_width = 0;
+    float label_height = 0;
+    std::vector<glm::vec3> translated_positions;
+};
+
+#endif // CELL_LABEL_CACHE_HPP
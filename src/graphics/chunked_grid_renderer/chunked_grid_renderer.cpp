@@ -0,0 +1,227 @@
+#include "chunked_grid_renderer.hpp"
+#include "../shader_program/shader_program.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// palette indices, the counts 0 to 8 come first
+enum CellColor : std::uint8_t { UNREVEALED = 9, FLAGGED = 10, SAFE_START = 11, NUM_CELL_COLORS = 12 };
+
+const int cells_per_chunk = ChunkedGridRenderer::CHUNK_SIZE * ChunkedGridRenderer::CHUNK_SIZE;
+
+const char *vertex_shader_source = R"glsl(
+#version 330 core
+
+// corners of a quad centered on the origin with side length 1
+layout (location = 0) in vec2 unit_position;
+
+// per instance
+layout (location = 1) in uint cell_color;
+
+// the chunk's first cell as (col, row) and how many cells are in each of its rows
+uniform ivec2 chunk_origin;
+uniform int chunk_width;
+
+uniform vec2 first_cell_center;
+uniform vec2 cell_pitch;
+uniform vec2 cell_size;
+
+uniform vec3 palette[12];
+
+out vec3 color;
+
+void main() {
+    ivec2 cell = chunk_origin + ivec2(gl_InstanceID % chunk_width, gl_InstanceID / chunk_width);
+    vec2 cell_center = first_cell_center + vec2(cell) * cell_pitch;
+    gl_Position = vec4(cell_center + unit_position * cell_size, 0.0, 1.0);
+    color = palette[cell_color];
+}
+)glsl";
+
+const char *fragment_shader_source = R"glsl(
+#version 330 core
+
+in vec3 color;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = vec4(color, 1.0);
+}
+)glsl";
+
+std::uint8_t get_cell_color(const FlatBoard &board, int row, int col) {
+    if (board.is_revealed(row, col)) {
+        return board.get_adjacent_mines(row, col);
+    }
+    if (board.is_flagged(row, col)) {
+        return FLAGGED;
+    }
+    if (board.is_safe_start(row, col)) {
+        return SAFE_START;
+    }
+    return UNREVEALED;
+}
+
+} // namespace
+
+ChunkedGridRenderer::ChunkedGridRenderer() {
+    shader_program = create_shader_program("chunked grid", vertex_shader_source, fragment_shader_source);
+    chunk_origin_location = glGetUniformLocation(shader_program, "chunk_origin");
+    chunk_width_location = glGetUniformLocation(shader_program, "chunk_width");
+    first_cell_center_location = glGetUniformLocation(shader_program, "first_cell_center");
+    cell_pitch_location = glGetUniformLocation(shader_program, "cell_pitch");
+    cell_size_location = glGetUniformLocation(shader_program, "cell_size");
+
+    const float unit_quad_vertices[] = {0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f, -0.5f, 0.5f};
+    const unsigned int unit_quad_indices[] = {0, 1, 3, 1, 2, 3};
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &quad_VBO);
+    glGenBuffers(1, &quad_IBO);
+    glGenBuffers(1, &cell_colors_VBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quad_VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(unit_quad_vertices), unit_quad_vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_IBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unit_quad_indices), unit_quad_indices, GL_STATIC_DRAW);
+
+    // the cell color pointer is set per chunk in draw, it points at that chunk's slot
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+}
+
+ChunkedGridRenderer::~ChunkedGridRenderer() {
+    glDeleteBuffers(1, &cell_colors_VBO);
+    glDeleteBuffers(1, &quad_IBO);
+    glDeleteBuffers(1, &quad_VBO);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteProgram(shader_program);
+}
+
+void ChunkedGridRenderer::set_colors(const std::array<glm::vec3, 9> &count_colors, const glm::vec3 &unrevealed_color,
+                                     const glm::vec3 &flagged_color, const glm::vec3 &safe_start_color) {
+    std::array<glm::vec3, NUM_CELL_COLORS> palette;
+    std::copy(count_colors.begin(), count_colors.end(), palette.begin());
+    palette[UNREVEALED] = unrevealed_color;
+    palette[FLAGGED] = flagged_color;
+    palette[SAFE_START] = safe_start_color;
+
+    glUseProgram(shader_program);
+    glUniform3fv(glGetUniformLocation(shader_program, "palette"), palette.size(), &palette[0].x);
+    glUseProgram(0);
+}
+
+void ChunkedGridRenderer::rebuild_chunk(const FlatBoard &board, int chunk_row, int chunk_col) {
+    int first_row = chunk_row * CHUNK_SIZE;
+    int first_col = chunk_col * CHUNK_SIZE;
+    int chunk_width = std::min(CHUNK_SIZE, num_cells_x - first_col);
+    int chunk_height = std::min(CHUNK_SIZE, num_cells_y - first_row);
+
+    std::uint8_t *chunk_colors =
+        cell_colors.data() + static_cast<std::size_t>(chunk_row * num_chunks_x + chunk_col) * cells_per_chunk;
+    for (int row = 0; row < chunk_height; row++) {
+        for (int col = 0; col < chunk_width; col++) {
+            chunk_colors[row * chunk_width + col] = get_cell_color(board, first_row + row, first_col + col);
+        }
+    }
+}
+
+void ChunkedGridRenderer::upload_chunk(int chunk_row, int chunk_col) {
+    int chunk_width = std::min(CHUNK_SIZE, num_cells_x - chunk_col * CHUNK_SIZE);
+    int chunk_height = std::min(CHUNK_SIZE, num_cells_y - chunk_row * CHUNK_SIZE);
+    std::size_t offset = static_cast<std::size_t>(chunk_row * num_chunks_x + chunk_col) * cells_per_chunk;
+    glBufferSubData(GL_ARRAY_BUFFER, offset, chunk_width * chunk_height, cell_colors.data() + offset);
+}
+
+void ChunkedGridRenderer::update(const FlatBoard &board) {
+    // a 64 bit word of a plane spans exactly two chunks of a row, any change in either half dirties that chunk
+    static_assert(CHUNK_SIZE == 32, "the word halves below assume two chunks per word");
+    bool any_dirty = false;
+    BoardChange change = uploaded_board.sync(board, [&](std::size_t word_index, std::uint64_t changed) {
+        int chunk_row = (word_index / board.words_per_row) / CHUNK_SIZE;
+        int first_chunk_col = (word_index % board.words_per_row) * 2;
+        if (changed & 0xffffffffu) {
+            dirty_chunks[chunk_row * num_chunks_x + first_chunk_col] = true;
+        }
+        // the padding bits past the last cell never change, so this chunk exists whenever it is marked
+        if (changed >> 32) {
+            dirty_chunks[chunk_row * num_chunks_x + first_chunk_col + 1] = true;
+        }
+        any_dirty = true;
+    });
+    if (change == BoardChange::NONE or (change == BoardChange::CELLS and not any_dirty)) {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, cell_colors_VBO);
+
+    if (change == BoardChange::NEW_BOARD) {
+        num_cells_x = board.num_cells_x;
+        num_cells_y = board.num_cells_y;
+        num_chunks_x = (num_cells_x + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        num_chunks_y = (num_cells_y + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        cell_colors.assign(static_cast<std::size_t>(num_chunks_x) * num_chunks_y * cells_per_chunk, UNREVEALED);
+        dirty_chunks.assign(static_cast<std::size_t>(num_chunks_x) * num_chunks_y, false);
+
+        for (int chunk_row = 0; chunk_row < num_chunks_y; chunk_row++) {
+            for (int chunk_col = 0; chunk_col < num_chunks_x; chunk_col++) {
+                rebuild_chunk(board, chunk_row, chunk_col);
+            }
+        }
+        glBufferData(GL_ARRAY_BUFFER, cell_colors.size(), cell_colors.data(), GL_DYNAMIC_DRAW);
+    } else {
+        for (int chunk_row = 0; chunk_row < num_chunks_y; chunk_row++) {
+            for (int chunk_col = 0; chunk_col < num_chunks_x; chunk_col++) {
+                if (dirty_chunks[chunk_row * num_chunks_x + chunk_col]) {
+                    rebuild_chunk(board, chunk_row, chunk_col);
+                    upload_chunk(chunk_row, chunk_col);
+                    dirty_chunks[chunk_row * num_chunks_x + chunk_col] = false;
+                }
+            }
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ChunkedGridRenderer::draw(const GridLayout &grid_layout) {
+    CellRange visible_cells = grid_layout.get_cells_overlapping(glm::vec2(-1, -1), glm::vec2(1, 1));
+    if (num_cells_x == 0 or visible_cells.is_empty()) {
+        return;
+    }
+
+    glUseProgram(shader_program);
+    glUniform2f(first_cell_center_location, grid_layout.first_cell_center.x, grid_layout.first_cell_center.y);
+    glUniform2f(cell_pitch_location, grid_layout.cell_pitch.x, grid_layout.cell_pitch.y);
+    glUniform2f(cell_size_location, grid_layout.cell_size.x, grid_layout.cell_size.y);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, cell_colors_VBO);
+    for (int chunk_row = visible_cells.min_row / CHUNK_SIZE; chunk_row <= visible_cells.max_row / CHUNK_SIZE;
+         chunk_row++) {
+        for (int chunk_col = visible_cells.min_col / CHUNK_SIZE; chunk_col <= visible_cells.max_col / CHUNK_SIZE;
+             chunk_col++) {
+            int chunk_width = std::min(CHUNK_SIZE, num_cells_x - chunk_col * CHUNK_SIZE);
+            int chunk_height = std::min(CHUNK_SIZE, num_cells_y - chunk_row * CHUNK_SIZE);
+            std::size_t offset = static_cast<std::size_t>(chunk_row * num_chunks_x + chunk_col) * cells_per_chunk;
+
+            // no base instance before gl 4.2, so the attribute is pointed at the chunk's slot instead
+            glVertexAttribIPointer(1, 1, GL_UNSIGNED_BYTE, 1, (void *)offset);
+            glUniform2i(chunk_origin_location, chunk_col * CHUNK_SIZE, chunk_row * CHUNK_SIZE);
+            glUniform1i(chunk_width_location, chunk_width);
+            glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, chunk_width * chunk_height);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
@@ -0,0 +1,81 @@
+#ifndef CHUNKED_GRID_RENDERER_HPP
+#define CHUNKED_GRID_RENDERER_HPP
+
+#include <array>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/vec3.hpp>
+#include <vector>
+
+#include "../../flat_board/board_change_tracker.hpp"
+#include "../../flat_board/flat_board.hpp"
+#include "../grid_layout/grid_layout.hpp"
+
+/**
+ * @brief Draws the cells of the minefield as instanced quads, split into square chunks that stay on the gpu.
+ *
+ * Each cell is a single byte on the gpu, an index into a small color palette, its position comes from its instance
+ * id and the layout uniforms. Every chunk owns a fixed slot in one buffer, a move only rebuilds and uploads the
+ * chunks whose cells changed, and drawing skips every chunk that is off screen. This keeps boards of millions of
+ * cells cheap as long as the camera is close enough for the cells to be worth drawing one by one.
+ */
+class ChunkedGridRenderer {
+  public:
+    static constexpr int CHUNK_SIZE = 32;
+
+    ChunkedGridRenderer();
+    ~ChunkedGridRenderer();
+
+    ChunkedGridRenderer(const ChunkedGridRenderer &) = delete;
+    ChunkedGridRenderer &operator=(const ChunkedGridRenderer &) = delete;
+
+    /**
+     * @param count_colors revealed cell colors indexed by adjacent mine count.
+     */
+    void set_colors(const std::array<glm::vec3, 9> &count_colors, const glm::vec3 &unrevealed_color,
+                    const glm::vec3 &flagged_color, const glm::vec3 &safe_start_color);
+
+    /**
+     * @brief Brings the chunks in line with the board.
+     *
+     * A new board (different size, mines or safe start) is rebuilt whole, otherwise only the chunks holding cells
+     * whose revealed or flagged bit changed are. Does nothing if the board hasn't changed since the last call.
+     */
+    void update(const FlatBoard &board);
+
+    /**
+     * @param grid_layout where the board is in NDC, chunks entirely outside of the screen aren't drawn.
+     */
+    void draw(const GridLayout &grid_layout);
+
+  private:
+    void rebuild_chunk(const FlatBoard &board, int chunk_row, int chunk_col);
+    void upload_chunk(int chunk_row, int chunk_col);
+
+    GLuint shader_program;
+    GLuint VAO;
+    GLuint quad_VBO;
+    GLuint quad_IBO;
+    GLuint cell_colors_VBO;
+
+    GLint chunk_origin_location;
+    GLint chunk_width_location;
+    GLint first_cell_center_location;
+    GLint cell_pitch_location;
+    GLint cell_size_location;
+
+    int num_cells_x = 0;
+    int num_cells_y = 0;
+    int num_chunks_x = 0;
+    int num_chunks_y = 0;
+
+    // palette index per cell, chunk after chunk with CHUNK_SIZE * CHUNK_SIZE bytes each, laid out row by row
+    // inside a chunk using the chunk's actual width
+    std::vector<std::uint8_t> cell_colors;
+
+    // what the gpu currently has
+    BoardChangeTracker uploaded_board;
+    std::vector<bool> dirty_chunks;
+};
+
+#endif // CHUNKED_GRID_RENDERER_HPP
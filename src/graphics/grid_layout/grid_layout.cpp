@@ -0,0 +1,55 @@
+#include "grid_layout.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+std::optional<std::pair<int, int>> GridLayout::get_cell_at(const glm::vec2 &ndc_position) const {
+    if (num_cells_x == 0 or num_cells_y == 0 or cell_pitch.x == 0 or cell_pitch.y == 0) {
+        return std::nullopt;
+    }
+
+    // the pitch can be negative, rounding the offset in pitches from the first center handles both directions
+    int col = std::lround((ndc_position.x - first_cell_center.x) / cell_pitch.x);
+    int row = std::lround((ndc_position.y - first_cell_center.y) / cell_pitch.y);
+    if (col < 0 or col >= num_cells_x or row < 0 or row >= num_cells_y) {
+        return std::nullopt;
+    }
+
+    float cell_center_x = first_cell_center.x + col * cell_pitch.x;
+    float cell_center_y = first_cell_center.y + row * cell_pitch.y;
+    if (std::abs(ndc_position.x - cell_center_x) > cell_size.x / 2 or
+        std::abs(ndc_position.y - cell_center_y) > cell_size.y / 2) {
+        return std::nullopt;
+    }
+    return std::make_pair(row, col);
+}
+
+namespace {
+/**
+ * @brief Along one axis, the first and last index of the cells whose extent overlaps [min, max].
+ */
+std::pair<int, int> get_overlapping_indices(float min, float max, float first_center, float pitch, float size,
+                                            int num_cells) {
+    // a cell overlaps when its center is within half a cell of the range, with a negative pitch the ends swap
+    float from = (min - size / 2 - first_center) / pitch;
+    float to = (max + size / 2 - first_center) / pitch;
+    // clamped while still a float, far off screen the index may not fit in an int
+    float first = std::clamp(std::ceil(std::min(from, to)), 0.0f, static_cast<float>(num_cells));
+    float last = std::clamp(std::floor(std::max(from, to)), -1.0f, static_cast<float>(num_cells - 1));
+    return {static_cast<int>(first), static_cast<int>(last)};
+}
+} // namespace
+
+CellRange GridLayout::get_cells_overlapping(const glm::vec2 &ndc_min, const glm::vec2 &ndc_max) const {
+    CellRange range;
+    if (num_cells_x == 0 or num_cells_y == 0 or cell_pitch.x == 0 or cell_pitch.y == 0) {
+        return range;
+    }
+
+    std::tie(range.min_col, range.max_col) =
+        get_overlapping_indices(ndc_min.x, ndc_max.x, first_cell_center.x, cell_pitch.x, cell_size.x, num_cells_x);
+    std::tie(range.min_row, range.max_row) =
+        get_overlapping_indices(ndc_min.y, ndc_max.y, first_cell_center.y, cell_pitch.y, cell_size.y, num_cells_y);
+    return range;
+}
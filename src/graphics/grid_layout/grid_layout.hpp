@@ -0,0 +1,46 @@
+#ifndef GRID_LAYOUT_HPP
+#define GRID_LAYOUT_HPP
+
+#include <glm/vec2.hpp>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief An inclusive rectangle of cells, empty when a max is below its min.
+ */
+struct CellRange {
+    int min_row = 0;
+    int max_row = -1;
+    int min_col = 0;
+    int max_col = -1;
+
+    bool is_empty() const { return max_row < min_row or max_col < min_col; }
+};
+
+/**
+ * @brief Where a uniform grid of cells sits in NDC, enough to go from a position to a cell without looking at every
+ * cell.
+ */
+struct GridLayout {
+    int num_cells_x = 0;
+    int num_cells_y = 0;
+    // center of the cell in row 0 and column 0
+    glm::vec2 first_cell_center{0};
+    // distance between neighboring cell centers including the spacing, negative when rows go down the screen
+    glm::vec2 cell_pitch{0};
+    glm::vec2 cell_size{0};
+
+    /**
+     * @return the row and column of the cell containing the position, nullopt if it is outside the grid or in the
+     * spacing between cells.
+     */
+    std::optional<std::pair<int, int>> get_cell_at(const glm::vec2 &ndc_position) const;
+
+    /**
+     * @brief The cells that overlap the rectangle between two corners, clamped to the grid, so drawing can skip
+     * everything off screen.
+     */
+    CellRange get_cells_overlapping(const glm::vec2 &ndc_min, const glm::vec2 &ndc_max) const;
+};
+
+#endif // GRID_LAYOUT_HPP
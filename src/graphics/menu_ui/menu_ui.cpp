@@ -0,0 +1,126 @@
+#include "menu_ui.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// text is kept off the edges of its box
+const float text_fill = 0.8;
+
+MenuBackground create_background(const MenuRect &rect, const glm::vec3 &color) {
+    float half_width = rect.width / 2;
+    float half_height = rect.height / 2;
+    MenuBackground background;
+    // top right, bottom right, bottom left, top left
+    background.xyz_positions = {glm::vec3(rect.center_x + half_width, rect.center_y + half_height, 0),
+                                glm::vec3(rect.center_x + half_width, rect.center_y - half_height, 0),
+                                glm::vec3(rect.center_x - half_width, rect.center_y - half_height, 0),
+                                glm::vec3(rect.center_x - half_width, rect.center_y + half_height, 0)};
+    background.rgb_colors.assign(4, color);
+    background.indices = {0, 1, 3, 1, 2, 3};
+    return background;
+}
+
+} // namespace
+
+bool MenuRect::contains(const glm::vec2 &point) const {
+    return std::abs(point.x - center_x) <= width / 2 and std::abs(point.y - center_y) <= height / 2;
+}
+
+void MenuUI::add_textbox(const std::string &text, float center_x, float center_y, float width, float height,
+                         const glm::vec3 &color) {
+    MenuRect rect{center_x, center_y, width, height};
+    text_boxes.push_back({rect, layout_text(text, rect), create_background(rect, color)});
+}
+
+void MenuUI::add_clickable_textbox(std::function<void()> on_click, const std::string &text, float center_x,
+                                   float center_y, float width, float height, const glm::vec3 &regular_color,
+                                   const glm::vec3 &hover_color) {
+    MenuClickableTextBox clickable_text_box;
+    clickable_text_box.on_click = std::move(on_click);
+    clickable_text_box.rect = {center_x, center_y, width, height};
+    clickable_text_box.regular_color = regular_color;
+    clickable_text_box.hover_color = hover_color;
+    clickable_text_box.text_mesh = layout_text(text, clickable_text_box.rect);
+    clickable_text_box.background = create_background(clickable_text_box.rect, regular_color);
+    clickable_text_boxes.push_back(std::move(clickable_text_box));
+}
+
+void MenuUI::add_input_box(std::function<void(std::string)> on_confirm, const std::string &placeholder_text,
+                           float center_x, float center_y, float width, float height, const glm::vec3 &regular_color,
+                           const glm::vec3 &focused_color) {
+    MenuInputBox input_box;
+    input_box.on_confirm = std::move(on_confirm);
+    input_box.rect = {center_x, center_y, width, height};
+    input_box.placeholder_text = placeholder_text;
+    input_box.regular_color = regular_color;
+    input_box.focused_color = focused_color;
+    input_box.background = create_background(input_box.rect, regular_color);
+    layout_input_box_text(input_box);
+    input_boxes.push_back(std::move(input_box));
+}
+
+void MenuUI::process_mouse_position(const glm::vec2 &mouse_position_ndc) {
+    for (auto &clickable_text_box : clickable_text_boxes) {
+        bool hovered = clickable_text_box.rect.contains(mouse_position_ndc);
+        if (hovered != clickable_text_box.hovered) {
+            clickable_text_box.hovered = hovered;
+            clickable_text_box.background.rgb_colors.assign(
+                4, hovered ? clickable_text_box.hover_color : clickable_text_box.regular_color);
+        }
+    }
+}
+
+void MenuUI::process_mouse_just_clicked(const glm::vec2 &mouse_position_ndc) {
+    for (auto &input_box : input_boxes) {
+        bool focused = input_box.rect.contains(mouse_position_ndc);
+        if (focused != input_box.focused) {
+            input_box.focused = focused;
+            input_box.background.rgb_colors.assign(4, focused ? input_box.focused_color : input_box.regular_color);
+        }
+    }
+    // a click can switch pages, which may replace this one, so nothing is touched after the callback
+    for (auto &clickable_text_box : clickable_text_boxes) {
+        if (clickable_text_box.rect.contains(mouse_position_ndc)) {
+            clickable_text_box.on_click();
+            return;
+        }
+    }
+}
+
+void MenuUI::process_key_press(const std::string &character) {
+    for (auto &input_box : input_boxes) {
+        if (input_box.focused) {
+            input_box.contents += character;
+            layout_input_box_text(input_box);
+        }
+    }
+}
+
+void MenuUI::process_delete_action() {
+    for (auto &input_box : input_boxes) {
+        if (input_box.focused and not input_box.contents.empty()) {
+            input_box.contents.pop_back();
+            layout_input_box_text(input_box);
+        }
+    }
+}
+
+void MenuUI::process_confirm_action() {
+    for (auto &input_box : input_boxes) {
+        if (input_box.focused) {
+            input_box.on_confirm(input_box.contents);
+        }
+    }
+}
+
+SDFTextMesh MenuUI::layout_text(const std::string &text, const MenuRect &rect) const {
+    return font->generate_text_mesh_size_constraints(text, rect.center_x, rect.center_y, rect.width * text_fill,
+                                                     rect.height * text_fill);
+}
+
+void MenuUI::layout_input_box_text(MenuInputBox &input_box) const {
+    input_box.text_mesh =
+        layout_text(input_box.contents.empty() ? input_box.placeholder_text : input_box.contents, input_box.rect);
+}
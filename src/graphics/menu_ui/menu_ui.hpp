@@ -0,0 +1,109 @@
+#ifndef MENU_UI_HPP
+#define MENU_UI_HPP
+
+#include <functional>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <string>
+#include <vector>
+
+#include "../sdf_font/sdf_font.hpp"
+
+/**
+ * @brief A solid colored box behind a menu element, in the layout the colored vertex shader takes.
+ */
+struct MenuBackground {
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec3> xyz_positions;
+    std::vector<glm::vec3> rgb_colors;
+};
+
+struct MenuRect {
+    float center_x;
+    float center_y;
+    float width;
+    float height;
+
+    bool contains(const glm::vec2 &point) const;
+};
+
+struct MenuTextBox {
+    MenuRect rect;
+    SDFTextMesh text_mesh;
+    MenuBackground background;
+};
+
+struct MenuClickableTextBox {
+    std::function<void()> on_click;
+    MenuRect rect;
+    glm::vec3 regular_color;
+    glm::vec3 hover_color;
+    bool hovered = false;
+    SDFTextMesh text_mesh;
+    MenuBackground background;
+};
+
+struct MenuInputBox {
+    std::function<void(std::string)> on_confirm;
+    MenuRect rect;
+    // shown while nothing has been typed
+    std::string placeholder_text;
+    std::string contents;
+    glm::vec3 regular_color;
+    glm::vec3 focused_color;
+    bool focused = false;
+    SDFTextMesh text_mesh;
+    MenuBackground background;
+};
+
+/**
+ * @brief One page of menu boxes, with their text laid out from an SDFFont.
+ *
+ * Stands in for the ui submodule's UI, which is built on the font_atlas submodule's FontAtlas. Positions and sizes
+ * are in ndc, boxes are centered on their position. Text and backgrounds are only laid out again when a box changes,
+ * so drawing a page that isn't being interacted with queues the same geometry every frame.
+ *
+ * Clicking an input box focuses it, typing goes to the focused box and confirming hands its contents to its
+ * callback.
+ */
+class MenuUI {
+  public:
+    explicit MenuUI(const SDFFont &font) : font(&font) {}
+
+    void add_textbox(const std::string &text, float center_x, float center_y, float width, float height,
+                     const glm::vec3 &color);
+    void add_clickable_textbox(std::function<void()> on_click, const std::string &text, float center_x,
+                               float center_y, float width, float height, const glm::vec3 &regular_color,
+                               const glm::vec3 &hover_color);
+    void add_input_box(std::function<void(std::string)> on_confirm, const std::string &placeholder_text,
+                       float center_x, float center_y, float width, float height, const glm::vec3 &regular_color,
+                       const glm::vec3 &focused_color);
+
+    void process_mouse_position(const glm::vec2 &mouse_position_ndc);
+    void process_mouse_just_clicked(const glm::vec2 &mouse_position_ndc);
+    /**
+     * @brief Appends to the focused input box.
+     */
+    void process_key_press(const std::string &character);
+    void process_delete_action();
+    /**
+     * @brief Hands the focused input box's contents to its callback.
+     */
+    void process_confirm_action();
+
+    const std::vector<MenuTextBox> &get_text_boxes() const { return text_boxes; }
+    const std::vector<MenuClickableTextBox> &get_clickable_text_boxes() const { return clickable_text_boxes; }
+    const std::vector<MenuInputBox> &get_input_boxes() const { return input_boxes; }
+
+  private:
+    SDFTextMesh layout_text(const std::string &text, const MenuRect &rect) const;
+    void layout_input_box_text(MenuInputBox &input_box) const;
+
+    // a pointer rather than a reference so pages can be reassigned in place
+    const SDFFont *font;
+    std::vector<MenuTextBox> text_boxes;
+    std::vector<MenuClickableTextBox> clickable_text_boxes;
+    std::vector<MenuInputBox> input_boxes;
+};
+
+#endif // MENU_UI_HPP
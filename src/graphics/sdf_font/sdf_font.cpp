@@ -0,0 +1,99 @@
+#include "sdf_font.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+SDFFont::SDFFont(BakedFontAtlas font_atlas) : font_atlas(std::move(font_atlas)) {
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // the baked texels are bottom row first, which is where texture coordinates start from, so no flip is needed
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, this->font_atlas.get_width(), this->font_atlas.get_height(), 0, GL_RED,
+                 GL_UNSIGNED_BYTE, this->font_atlas.get_texels());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // the png the atlas is baked from is grey and opaque, so the text shader sees the same thing it used to
+    GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+SDFFont::~SDFFont() { glDeleteTextures(1, &texture); }
+
+SDFTextMesh SDFFont::generate_text_mesh_size_constraints(std::string_view text, float center_x, float center_y,
+                                                         float width, float height) const {
+    // first pass finds the extent of the line in atlas texels, with the pen starting at 0 on the baseline
+    float min_x = std::numeric_limits<float>::max(), min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest(), max_y = std::numeric_limits<float>::lowest();
+    float pen_x = 0;
+    std::size_t num_glyphs = 0;
+    for (unsigned char character : text) {
+        const BakedGlyph *glyph = font_atlas.get_glyph(character);
+        if (glyph == nullptr) {
+            continue;
+        }
+        float left = pen_x - glyph->origin_x;
+        float top = glyph->origin_y;
+        min_x = std::min(min_x, left);
+        max_x = std::max(max_x, left + glyph->width);
+        min_y = std::min(min_y, top - glyph->height);
+        max_y = std::max(max_y, top);
+        pen_x += glyph->advance;
+        num_glyphs++;
+    }
+
+    SDFTextMesh text_mesh;
+    if (num_glyphs == 0 or max_x <= min_x or max_y <= min_y) {
+        return text_mesh;
+    }
+
+    float scale = std::min(width / (max_x - min_x), height / (max_y - min_y));
+    glm::vec2 offset(center_x - scale * (min_x + max_x) / 2, center_y - scale * (min_y + max_y) / 2);
+
+    text_mesh.indices.reserve(6 * num_glyphs);
+    text_mesh.vertex_positions.reserve(4 * num_glyphs);
+    text_mesh.texture_coordinates.reserve(4 * num_glyphs);
+
+    float atlas_width = font_atlas.get_width();
+    float atlas_height = font_atlas.get_height();
+    pen_x = 0;
+    for (unsigned char character : text) {
+        const BakedGlyph *glyph = font_atlas.get_glyph(character);
+        if (glyph == nullptr) {
+            continue;
+        }
+        float left = offset.x + scale * (pen_x - glyph->origin_x);
+        float top = offset.y + scale * glyph->origin_y;
+        float right = left + scale * glyph->width;
+        float bottom = top - scale * glyph->height;
+
+        float u_left = glyph->x / atlas_width;
+        float u_right = (glyph->x + glyph->width) / atlas_width;
+        float v_bottom = glyph->y / atlas_height;
+        float v_top = (glyph->y + glyph->height) / atlas_height;
+
+        unsigned int first_vertex = text_mesh.vertex_positions.size();
+        // top right, bottom right, bottom left, top left
+        text_mesh.vertex_positions.insert(text_mesh.vertex_positions.end(),
+                                          {glm::vec3(right, top, 0), glm::vec3(right, bottom, 0),
+                                           glm::vec3(left, bottom, 0), glm::vec3(left, top, 0)});
+        text_mesh.texture_coordinates.insert(text_mesh.texture_coordinates.end(),
+                                             {glm::vec2(u_right, v_top), glm::vec2(u_right, v_bottom),
+                                              glm::vec2(u_left, v_bottom), glm::vec2(u_left, v_top)});
+        for (unsigned int index : {0u, 1u, 3u, 1u, 2u, 3u}) {
+            text_mesh.indices.push_back(first_vertex + index);
+        }
+
+        pen_x += glyph->advance;
+    }
+    return text_mesh;
+}
+
+void SDFFont::bind_texture() const {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
@@ -0,0 +1,61 @@
+#ifndef SDF_FONT_HPP
+#define SDF_FONT_HPP
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <string_view>
+#include <vector>
+
+#include "../baked_font_atlas/baked_font_atlas.hpp"
+
+/**
+ * @brief A line of text as quads into the font's atlas, ready for the signed distance field text shader.
+ */
+struct SDFTextMesh {
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec3> vertex_positions;
+    std::vector<glm::vec2> texture_coordinates;
+};
+
+/**
+ * @brief Lays out text from a baked signed distance field atlas and owns the atlas' texture.
+ *
+ * Replaces the font_atlas submodule's FontAtlas, which parsed the atlas jsons and decoded the png on every start
+ * and looked every glyph up in a hash map. Here loading is the atlas' memory map plus one texture upload, and a
+ * glyph is an index into the baked table.
+ *
+ * Only ascii has glyphs in the atlases we bake, so text is laid out a byte at a time, anything without a glyph is
+ * skipped.
+ */
+class SDFFont {
+  public:
+    /**
+     * @brief Uploads the atlas, so the gl context has to be current.
+     */
+    explicit SDFFont(BakedFontAtlas font_atlas);
+    ~SDFFont();
+
+    SDFFont(const SDFFont &) = delete;
+    SDFFont &operator=(const SDFFont &) = delete;
+
+    /**
+     * @brief Lays the text out on one line, as large as fits in the width by height box centered on (center_x,
+     * center_y) without stretching it.
+     */
+    SDFTextMesh generate_text_mesh_size_constraints(std::string_view text, float center_x, float center_y, float width,
+                                                    float height) const;
+
+    /**
+     * @brief Binds the atlas to texture unit 0, where the text shader samples it from.
+     */
+    void bind_texture() const;
+
+    const BakedFontAtlas &get_font_atlas() const { return font_atlas; }
+
+  private:
+    BakedFontAtlas font_atlas;
+    GLuint texture;
+};
+
+#endif // SDF_FONT_HPP
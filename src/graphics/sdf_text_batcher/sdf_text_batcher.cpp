@@ -0,0 +1,135 @@
+#include "sdf_text_batcher.hpp"
+#include "../shader_program/shader_program.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+namespace {
+
+const char *vertex_shader_source = R"glsl(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 passthrough_texture_coordinate;
+
+uniform mat4 transform;
+
+out vec2 texture_coordinate;
+
+void main() {
+    gl_Position = transform * vec4(position, 1.0);
+    texture_coordinate = passthrough_texture_coordinate;
+}
+)glsl";
+
+const char *fragment_shader_source = R"glsl(
+#version 330 core
+
+in vec2 texture_coordinate;
+
+uniform sampler2D font_atlas;
+uniform vec3 rgb_color;
+uniform float character_width;
+uniform float edge_transition_width;
+
+out vec4 frag_color;
+
+void main() {
+    // the atlas stores 1 inside a glyph falling to 0 outside, so this is the distance out from the glyph's middle
+    float distance = 1.0 - texture(font_atlas, texture_coordinate).r;
+    float alpha = 1.0 - smoothstep(character_width, character_width + edge_transition_width, distance);
+    frag_color = vec4(rgb_color, alpha);
+}
+)glsl";
+
+} // namespace
+
+SDFTextBatcher::SDFTextBatcher() {
+    shader_program = create_shader_program("signed distance field text", vertex_shader_source, fragment_shader_source);
+    transform_location = glGetUniformLocation(shader_program, "transform");
+    color_location = glGetUniformLocation(shader_program, "rgb_color");
+    character_width_location = glGetUniformLocation(shader_program, "character_width");
+    edge_transition_width_location = glGetUniformLocation(shader_program, "edge_transition_width");
+
+    glUseProgram(shader_program);
+    glUniform1i(glGetUniformLocation(shader_program, "font_atlas"), 0);
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &TBO);
+    glGenBuffers(1, &IBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, TBO);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void *)0);
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+
+    glBindVertexArray(0);
+}
+
+SDFTextBatcher::~SDFTextBatcher() {
+    GLuint buffers[] = {VBO, TBO, IBO};
+    glDeleteBuffers(3, buffers);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteProgram(shader_program);
+}
+
+void SDFTextBatcher::set_transform(const glm::mat4 &transform) {
+    glUseProgram(shader_program);
+    glUniformMatrix4fv(transform_location, 1, GL_FALSE, glm::value_ptr(transform));
+    glUseProgram(0);
+}
+
+void SDFTextBatcher::set_style(const glm::vec3 &color, float character_width, float edge_transition_width) {
+    glUseProgram(shader_program);
+    glUniform3f(color_location, color.x, color.y, color.z);
+    glUniform1f(character_width_location, character_width);
+    glUniform1f(edge_transition_width_location, edge_transition_width);
+    glUseProgram(0);
+}
+
+void SDFTextBatcher::queue_draw(const std::vector<unsigned int> &indices,
+                                const std::vector<glm::vec3> &vertex_positions,
+                                const std::vector<glm::vec2> &texture_coordinates) {
+    unsigned int index_offset = this->vertex_positions.size();
+    this->vertex_positions.insert(this->vertex_positions.end(), vertex_positions.begin(), vertex_positions.end());
+    this->texture_coordinates.insert(this->texture_coordinates.end(), texture_coordinates.begin(),
+                                     texture_coordinates.end());
+    for (unsigned int index : indices) {
+        this->indices.push_back(index_offset + index);
+    }
+}
+
+void SDFTextBatcher::draw_everything() {
+    if (indices.empty()) {
+        return;
+    }
+
+    glUseProgram(shader_program);
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertex_positions.size() * sizeof(glm::vec3), vertex_positions.data(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, TBO);
+    glBufferData(GL_ARRAY_BUFFER, texture_coordinates.size() * sizeof(glm::vec2), texture_coordinates.data(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STREAM_DRAW);
+
+    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    vertex_positions.clear();
+    texture_coordinates.clear();
+    indices.clear();
+}
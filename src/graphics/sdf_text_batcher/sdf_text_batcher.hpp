@@ -0,0 +1,64 @@
+#ifndef SDF_TEXT_BATCHER_HPP
+#define SDF_TEXT_BATCHER_HPP
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/**
+ * @brief Batches signed distance field text into one draw per tick.
+ *
+ * Takes over from the generated Batcher's TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT batcher, which needed the
+ * shader cache to compile its program from source on every launch. This one's program goes through
+ * create_shader_program, so it comes out of the program binary cache after the first run.
+ *
+ * @note the font's atlas has to be bound to texture unit 0 when drawing, see SDFFont::bind_texture.
+ */
+class SDFTextBatcher {
+  public:
+    /**
+     * @brief Builds the program, so the gl context has to be current.
+     */
+    SDFTextBatcher();
+    ~SDFTextBatcher();
+
+    SDFTextBatcher(const SDFTextBatcher &) = delete;
+    SDFTextBatcher &operator=(const SDFTextBatcher &) = delete;
+
+    void set_transform(const glm::mat4 &transform);
+
+    /**
+     * @param character_width distance field value where a glyph's edge is, 0.5 for the atlases we bake.
+     * @param edge_transition_width how far past the edge a glyph fades out, larger is blurrier.
+     */
+    void set_style(const glm::vec3 &color, float character_width, float edge_transition_width);
+
+    /**
+     * @note indices are local to the text, the same as with the generated batcher.
+     */
+    void queue_draw(const std::vector<unsigned int> &indices, const std::vector<glm::vec3> &vertex_positions,
+                    const std::vector<glm::vec2> &texture_coordinates);
+
+    void draw_everything();
+
+  private:
+    GLuint shader_program;
+    GLuint VAO;
+    GLuint VBO;
+    GLuint TBO;
+    GLuint IBO;
+
+    GLint transform_location;
+    GLint color_location;
+    GLint character_width_location;
+    GLint edge_transition_width_location;
+
+    // cleared after every draw, they keep their capacity so a steady amount of text doesn't touch the heap
+    std::vector<glm::vec3> vertex_positions;
+    std::vector<glm::vec2> texture_coordinates;
+    std::vector<unsigned int> indices;
+};
+
+#endif // SDF_TEXT_BATCHER_HPP
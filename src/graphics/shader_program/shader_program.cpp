@@ -0,0 +1,203 @@
+#include "shader_program.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+// glad only has the program binary functions when it's generated for gl 4.1 or with the extension
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+#define PROGRAM_BINARY_CACHE_AVAILABLE
+#endif
+
+namespace {
+
+std::string program_binary_cache_directory;
+
+GLuint compile_shader(GLenum type, const char *source, const std::string &description) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (not success) {
+        GLint log_length;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_length);
+        std::vector<char> log(log_length + 1, '\0');
+        glGetShaderInfoLog(shader, log_length, nullptr, log.data());
+        glDeleteShader(shader);
+        throw std::runtime_error("failed to compile " + description + ": " + log.data());
+    }
+    return shader;
+}
+
+GLuint link_program(const std::string &name, const char *vertex_shader_source, const char *fragment_shader_source,
+                    bool retrievable) {
+    GLuint vertex_shader = compile_shader(GL_VERTEX_SHADER, vertex_shader_source, name + " vertex shader");
+    GLuint fragment_shader;
+    try {
+        fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_shader_source, name + " fragment shader");
+    } catch (...) {
+        glDeleteShader(vertex_shader);
+        throw;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+#ifdef PROGRAM_BINARY_CACHE_AVAILABLE
+    if (retrievable) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+    glLinkProgram(program);
+
+    // the program keeps what it needs once linked
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (not success) {
+        GLint log_length;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
+        std::vector<char> log(log_length + 1, '\0');
+        glGetProgramInfoLog(program, log_length, nullptr, log.data());
+        glDeleteProgram(program);
+        throw std::runtime_error("failed to link " + name + ": " + log.data());
+    }
+    return program;
+}
+
+#ifdef PROGRAM_BINARY_CACHE_AVAILABLE
+
+// a cached binary is this magic, the driver's binary format and then the binary itself. it's only ever read back by
+// the same driver so nothing is byte swapped
+constexpr char program_binary_magic[4] = {'C', 'J', 'M', 'P'};
+constexpr std::size_t program_binary_header_size = sizeof(program_binary_magic) + sizeof(GLenum);
+
+bool driver_supports_program_binaries() {
+    bool has_program_binary = false;
+#ifdef GL_VERSION_4_1
+    has_program_binary = has_program_binary or GLAD_GL_VERSION_4_1;
+#endif
+#ifdef GL_ARB_get_program_binary
+    has_program_binary = has_program_binary or GLAD_GL_ARB_get_program_binary;
+#endif
+    if (not has_program_binary) {
+        return false;
+    }
+    // some drivers have the functions but no format to save in
+    GLint num_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    return num_formats > 0;
+}
+
+std::string get_gl_string(GLenum name) {
+    const GLubyte *value = glGetString(name);
+    return value ? reinterpret_cast<const char *>(value) : "";
+}
+
+std::filesystem::path get_program_binary_path(const char *vertex_shader_source, const char *fragment_shader_source) {
+    // fnv-1a, it only has to tell programs apart. the terminators are hashed too so where one part ends matters
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const std::string &part : {std::string(vertex_shader_source), std::string(fragment_shader_source),
+                                    get_gl_string(GL_VENDOR), get_gl_string(GL_RENDERER), get_gl_string(GL_VERSION)}) {
+        for (std::size_t i = 0; i <= part.size(); i++) {
+            hash = (hash ^ static_cast<unsigned char>(part.c_str()[i])) * 1099511628211ull;
+        }
+    }
+    char file_name[32];
+    std::snprintf(file_name, sizeof(file_name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return std::filesystem::path(program_binary_cache_directory) / file_name;
+}
+
+/**
+ * @return the program, or 0 if nothing is cached or the driver rejected it.
+ */
+GLuint load_program_binary(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+        return 0;
+    }
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (contents.size() <= program_binary_header_size or
+        std::memcmp(contents.data(), program_binary_magic, sizeof(program_binary_magic)) != 0) {
+        return 0;
+    }
+    GLenum binary_format;
+    std::memcpy(&binary_format, contents.data() + sizeof(program_binary_magic), sizeof(binary_format));
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, binary_format, contents.data() + program_binary_header_size,
+                    static_cast<GLsizei>(contents.size() - program_binary_header_size));
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (not success) {
+        glDeleteProgram(program);
+        // an unknown format is also reported as an error, don't leave it for whoever checks next
+        glGetError();
+        return 0;
+    }
+    return program;
+}
+
+void save_program_binary(GLuint program, const std::filesystem::path &path) {
+    GLint binary_length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+    if (binary_length <= 0) {
+        return;
+    }
+    std::vector<char> contents(program_binary_header_size + binary_length);
+    GLenum binary_format;
+    glGetProgramBinary(program, binary_length, nullptr, &binary_format, contents.data() + program_binary_header_size);
+    std::memcpy(contents.data(), program_binary_magic, sizeof(program_binary_magic));
+    std::memcpy(contents.data() + sizeof(program_binary_magic), &binary_format, sizeof(binary_format));
+
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    // written beside it and renamed over it, so a run that's cut off never leaves half a binary behind
+    std::filesystem::path temporary_path = path;
+    temporary_path += ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (not file.write(contents.data(), contents.size())) {
+            std::cout << "unable to write program binary: " << temporary_path << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        std::cout << "unable to write program binary: " << path << ": " << error.message() << std::endl;
+    }
+}
+
+#endif
+
+} // namespace
+
+GLuint create_shader_program(const std::string &name, const char *vertex_shader_source,
+                             const char *fragment_shader_source) {
+#ifdef PROGRAM_BINARY_CACHE_AVAILABLE
+    if (not program_binary_cache_directory.empty() and driver_supports_program_binaries()) {
+        std::filesystem::path binary_path = get_program_binary_path(vertex_shader_source, fragment_shader_source);
+        GLuint program = load_program_binary(binary_path);
+        if (program != 0) {
+            return program;
+        }
+        // a rejected binary is simply replaced by the freshly linked one
+        program = link_program(name, vertex_shader_source, fragment_shader_source, true);
+        save_program_binary(program, binary_path);
+        return program;
+    }
+#endif
+    return link_program(name, vertex_shader_source, fragment_shader_source, false);
+}
+
+void set_program_binary_cache_directory(const std::string &directory) { program_binary_cache_directory = directory; }
@@ -0,0 +1,30 @@
+#ifndef SHADER_PROGRAM_HPP
+#define SHADER_PROGRAM_HPP
+
+#include <glad/glad.h>
+#include <string>
+
+/**
+ * @brief Compiles and links a program from glsl source, for the in-tree renderers whose shaders aren't part of the
+ * shader cache.
+ *
+ * @param name only used to say which program failed in error messages.
+ * @note throws std::runtime_error with the driver's log if the program doesn't build.
+ */
+GLuint create_shader_program(const std::string &name, const char *vertex_shader_source,
+                             const char *fragment_shader_source);
+
+/**
+ * @brief Makes create_shader_program keep the linked programs it builds in this directory and reuse them on later
+ * runs, instead of compiling from source every launch.
+ *
+ * A cached program is keyed by its source and the driver's vendor, renderer and version strings, so editing a
+ * shader or updating the driver just misses the cache. If the driver rejects a cached binary anyway the program is
+ * compiled from source and the binary replaced.
+ *
+ * @param directory created if it doesn't exist, empty turns caching off, which is the default.
+ * @note does nothing when the gl loader or the driver doesn't support program binaries.
+ */
+void set_program_binary_cache_directory(const std::string &directory);
+
+#endif // SHADER_PROGRAM_HPP
@@ -6,16 +6,39 @@
 #include "shader_cache/shader_cache.hpp"
 #include "vertex_geometry/vertex_geometry.hpp"
 #include "window/window.hpp"
-#include "sound_system/sound_system.hpp"
+#include "pooled_sound_system/pooled_sound_system.hpp"
 #include "game_logic/game_logic.hpp"
-#include "game_logic/solver.hpp"
-#include "graphics/batcher/generated/batcher.hpp"
-#include "graphics/ui/ui.hpp"
+#include "flat_board/flat_board.hpp"
+#include "flat_board/board_conversion.hpp"
+#include "ngs_solver/ngs_solver.hpp"
+#include "ngs_generator/ngs_generator.hpp"
+#include "board_prefetch_queue/board_prefetch_queue.hpp"
+#include "board_store/board_store.hpp"
+#include "frame_pacer/frame_pacer.hpp"
+#include "frame_profiler/frame_profiler.hpp"
+#include "allocation_counter/allocation_counter.hpp"
+#include "startup_timeline/startup_timeline.hpp"
+#include "graphics/batcher.hpp"
+#include "graphics/shader_program/shader_program.hpp"
+#include "graphics/chunked_grid_renderer/chunked_grid_renderer.hpp"
+#include "graphics/board_texture_renderer/board_texture_renderer.hpp"
+#include "graphics/baked_font_atlas/baked_font_atlas.hpp"
+#include "graphics/sdf_font/sdf_font.hpp"
+#include "graphics/sdf_text_batcher/sdf_text_batcher.hpp"
+#include "graphics/cell_label_cache/cell_label_cache.hpp"
+#include "graphics/grid_layout/grid_layout.hpp"
+#include "graphics/camera_2d/camera_2d.hpp"
+#include "graphics/menu_ui/menu_ui.hpp"
 #include "graphics/colors/colors.hpp"
 #include "graphics/glfw_lambda_callback_manager/glfw_lambda_callback_manager.hpp"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <future>
 #include <iostream>
 #include <iomanip> // For formatting output
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <glm/vec3.hpp> // Ensure you include the GLM library for glm::vec3
@@ -39,18 +62,59 @@ const auto flagged_cell_color = colors.brown;
 const auto ngs_start_pos_color = colors.limegreen;
 
 const auto text_color = colors.black;
+
+// once cells are smaller than this on screen the board is drawn as a single textured quad instead of per cell
+const float board_texture_max_cell_pixels = 6;
+// smaller cells than this don't get their labels drawn by the per cell path, they'd be unreadable anyway
+const float cell_label_min_cell_pixels = 10;
+// how far a press of an arrow key moves the view, in screens
+const float camera_pan_step = 0.1;
+const float camera_zoom_step = 1.25;
 const auto flag_text_color = colors.purple;
 
-bool is_point_in_rectangle(const Rectangle &rect, const glm::vec3 &point) {
-    float half_width = rect.width / 2.0f;
-    float half_height = rect.height / 2.0f;
+/**
+ * @brief Lays out one line of text per profiled phase, down the top left of the screen.
+ */
+std::vector<SDFTextMesh> create_profiler_overlay(const SDFFont &font, const FrameProfiler &frame_profiler,
+                                                std::size_t heap_allocations_last_frame) {
+    std::vector<SDFTextMesh> overlay_lines;
+    float line_height = 0.06;
+    float line_y = 0.9;
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "render thread heap allocations last frame: %zu", heap_allocations_last_frame);
+    overlay_lines.push_back(font.generate_text_mesh_size_constraints(line, -0.55, line_y, 0.8, line_height));
+    line_y -= line_height * 1.25;
+
+    for (const auto &phase : frame_profiler.get_statistics()) {
+        std::snprintf(line, sizeof(line), "%s%s  p50 %.2fms  p99 %.2fms", phase.name, phase.gpu ? " (gpu)" : "",
+                      phase.p50_ms, phase.p99_ms);
+        overlay_lines.push_back(font.generate_text_mesh_size_constraints(line, -0.55, line_y, 0.8, line_height));
+        line_y -= line_height * 1.25;
+    }
+    return overlay_lines;
+}
 
-    float left_bound = rect.center.x - half_width;
-    float right_bound = rect.center.x + half_width;
-    float bottom_bound = rect.center.y - half_height;
-    float top_bound = rect.center.y + half_height;
+/**
+ * @brief Lays the board out in world space with square cells, as large as fit in the width by height area around
+ * center, row 0 at the top.
+ */
+GridLayout create_grid_layout(int num_cells_x, int num_cells_y) {
+    GridLayout grid_layout;
+    if (num_cells_x == 0 or num_cells_y == 0) {
+        return grid_layout;
+    }
 
-    return (point.x >= left_bound && point.x <= right_bound && point.y >= bottom_bound && point.y <= top_bound);
+    float pitch = std::min(width / num_cells_x, height / num_cells_y);
+    // on big boards the fixed spacing would swallow the cells, so it's capped at a tenth of the pitch
+    float cell_side = pitch - std::min(spacing, pitch * 0.1f);
+    grid_layout.num_cells_x = num_cells_x;
+    grid_layout.num_cells_y = num_cells_y;
+    grid_layout.first_cell_center =
+        glm::vec2(center.x - pitch * (num_cells_x - 1) / 2, center.y + pitch * (num_cells_y - 1) / 2);
+    grid_layout.cell_pitch = glm::vec2(pitch, -pitch);
+    grid_layout.cell_size = glm::vec2(cell_side, cell_side);
+    return grid_layout;
 }
 
 std::string key_to_string(int key) {
@@ -71,7 +135,7 @@ std::string key_to_string(int key) {
     return (it != key_map.end()) ? it->second : "";
 }
 
-void process_key_pressed_this_tick(UI &ui, int &key_pressed_this_tick) {
+void process_key_pressed_this_tick(MenuUI &ui, int &key_pressed_this_tick) {
     if (key_pressed_this_tick != GLFW_KEY_UNKNOWN) {
         std::string key_string = key_to_string(key_pressed_this_tick);
         if (!key_string.empty()) {
@@ -104,66 +168,93 @@ std::pair<float, float> convert_mouse_to_ndc(double mouse_x, double mouse_y, int
     return {ndc_x, ndc_y};
 }
 
-std::vector<glm::vec3> generate_colors_for_indices(const std::vector<glm::vec3> &input_colors) {
-    std::vector<glm::vec3> duplicated_colors;
-    duplicated_colors.reserve(input_colors.size() * 4); // Reserve space for efficiency
-
-    for (const auto &color : input_colors) {
-        // Push the same color four times
-        duplicated_colors.push_back(color);
-        duplicated_colors.push_back(color);
-        duplicated_colors.push_back(color);
-        duplicated_colors.push_back(color);
-    }
-
-    return duplicated_colors;
-}
+/**
+ * @brief An image decoded to rgba, top row first, that hasn't been handed to glfw or gl yet.
+ */
+struct DecodedImage {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
 
-Board generate_ng_solvable_board(int mine_count, int num_cells_x, int num_cells_y) {
-    Solver solver;
-    Board board = generate_board(mine_count, num_cells_x, num_cells_y);
-    // keep trying until we genrate a ngsolvable board
-    std::optional<std::pair<int, int>> solution = solver.solve(board, mine_count);
-    while (not solution.has_value()) {
-        std::cout << "gnerating a new board and trying again" << std::endl;
-        board = generate_board(mine_count, num_cells_x, num_cells_y);
-        solution = solver.solve(board, mine_count);
+/**
+ * @brief Decodes an image without touching glfw or gl, so it can run on a worker thread.
+ * @return an empty image if it couldn't be loaded
+ */
+DecodedImage decode_image(const std::string &image_path) {
+    DecodedImage image;
+    int channels;
+    unsigned char *data = stbi_load(image_path.c_str(), &image.width, &image.height, &channels, 4); // 4 = RGBA channels
+    if (!data) {
+        std::cerr << "Failed to load image: " << image_path << std::endl;
+        return {};
     }
-
-    auto [row, col] = solution.value();
-    board[row][col].safe_start = true;
-
-    return board;
+    image.pixels.assign(data, data + 4 * static_cast<std::size_t>(image.width) * image.height);
+    stbi_image_free(data);
+    return image;
 }
 
-GLFWcursor *create_custom_cursor(const char *image_path, int hotspot_x, int hotspot_y) {
-    // Load image data using stb_image
-    int width, height, channels;
-    unsigned char *data = stbi_load(image_path, &width, &height, &channels, 4); // 4 = RGBA channels
-    if (!data) {
-        std::cerr << "Failed to load cursor image: " << image_path << std::endl;
+GLFWcursor *create_custom_cursor(DecodedImage &decoded_image, int hotspot_x, int hotspot_y) {
+    if (decoded_image.pixels.empty()) {
         return nullptr;
     }
 
     // Create an image for the GLFW cursor
     GLFWimage image;
-    image.width = width;
-    image.height = height;
-    image.pixels = data;
+    image.width = decoded_image.width;
+    image.height = decoded_image.height;
+    image.pixels = decoded_image.pixels.data();
 
-    // Create the cursor with the given hotspot
-    GLFWcursor *cursor = glfwCreateCursor(&image, hotspot_x, hotspot_y);
+    // Create the cursor with the given hotspot, glfw copies the pixels
+    return glfwCreateCursor(&image, hotspot_x, hotspot_y);
+}
 
-    // Free image data after cursor creation
-    stbi_image_free(data);
+/**
+ * @brief Destroys the window and shuts glfw down when it goes out of scope.
+ *
+ * Made right after the window opens, so everything made after it is destroyed first, while the context its gl
+ * objects belong to still exists.
+ */
+struct GlfwTeardown {
+    GLFWwindow *window;
+    ~GlfwTeardown() {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+};
+
+template <typename T> bool is_ready(const std::future<T> &future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
 
-    return cursor;
+/**
+ * @brief Starts a startup step on its own thread, timed on the startup timeline.
+ */
+template <typename Step>
+auto load_in_background(StartupTimeline &startup_timeline, const std::string &name, Step step) {
+    return std::async(std::launch::async, [&startup_timeline, name, step = std::move(step)]() mutable {
+        // stb's flip setting is global unless a thread sets its own, pinning it here means the main thread flipping
+        // while it loads its own images can't flip these
+        stbi_set_flip_vertically_on_load_thread(false);
+        return startup_timeline.time(name, step);
+    });
 }
 
 enum GameState { MAIN_MENU, OPTIONS_PAGE, IN_GAME, END_GAME };
 
-UI create_main_menu(GLFWwindow *window, FontAtlas &font_atlas, GameState &curr_state) {
-    UI main_menu_ui(font_atlas);
+// mine reveals an unrevealed cell or chords a revealed one, flag toggles an unrevealed cell's flag or flags around a
+// revealed one, and unflag clears the flags around a cell
+enum class CellAction { MINE, FLAG, UNFLAG };
+
+struct QueuedCellAction {
+    CellAction action;
+    // where the cursor was when the input happened, in screen space
+    double mouse_x;
+    double mouse_y;
+};
+
+MenuUI create_main_menu(GLFWwindow *window, const SDFFont &font, GameState &curr_state) {
+    MenuUI main_menu_ui(font);
 
     std::function<void()> on_play = [&]() { curr_state = OPTIONS_PAGE; };
     std::function<void()> on_quit = [&]() { glfwSetWindowShouldClose(window, GLFW_TRUE); };
@@ -175,10 +266,11 @@ UI create_main_menu(GLFWwindow *window, FontAtlas &font_atlas, GameState &curr_s
     return main_menu_ui;
 }
 
-UI create_options_page(FontAtlas &font_atlas, GameState &curr_state, Board &board, float &mine_percentage,
-                       int &num_cells_x, int &num_cells_y, int &mine_count, std::vector<Rectangle> &grid_rectangles,
-                       int &games_threshold) {
-    UI in_game_ui(font_atlas);
+MenuUI create_options_page(const SDFFont &font, GameState &curr_state, FlatBoard &board, float &mine_percentage,
+                       int &num_cells_x, int &num_cells_y, int &mine_count,
+                       int &games_threshold, bool &no_guess, NGSGenerationMode &ngs_generation_mode,
+                       BoardPrefetchQueue &board_queue) {
+    MenuUI in_game_ui(font);
 
     std::function<void(std::string)> on_width_confirm = [&](std::string contents) {
         if (contents.empty())
@@ -207,8 +299,13 @@ UI create_options_page(FontAtlas &font_atlas, GameState &curr_state, Board &boar
     std::function<void()> on_back = [&]() { curr_state = MAIN_MENU; };
     std::function<void()> on_play = [&]() {
         // TODO: NGS config
-        board = generate_ng_solvable_board(mine_count, num_cells_x, num_cells_y);
-        grid_rectangles = generate_grid_rectangles(center, width, height, num_cells_y, num_cells_x, spacing);
+        // popping a board nobody can generate would block the render thread for good
+        if (not board_queue.set_configuration(mine_count, num_cells_x, num_cells_y, no_guess, ngs_generation_mode)) {
+            std::cout << "can't generate a " << num_cells_x << "x" << num_cells_y << " board with " << mine_count
+                      << " mines, pick fewer mines or a bigger board" << std::endl;
+            return;
+        }
+        board = board_queue.pop();
         curr_state = IN_GAME;
     };
 
@@ -224,8 +321,8 @@ UI create_options_page(FontAtlas &font_atlas, GameState &curr_state, Board &boar
     return in_game_ui;
 }
 
-UI create_ending_page(GLFWwindow *window, FontAtlas &font_atlas, GameState &curr_state, double avg_time) {
-    UI end_ui(font_atlas);
+MenuUI create_ending_page(GLFWwindow *window, const SDFFont &font, GameState &curr_state, double avg_time) {
+    MenuUI end_ui(font);
 
     std::function<void()> on_play = [&]() { curr_state = OPTIONS_PAGE; };
     std::function<void()> on_quit = [&]() { glfwSetWindowShouldClose(window, GLFW_TRUE); };
@@ -266,18 +363,30 @@ SoundType get_random_flag_sound() {
 }
 
 int main() {
+    // first, so every step of startup is measured from the same point
+    StartupTimeline startup_timeline;
+
     float mine_percentage = 0.01;
     int num_cells_x = 10;
     int num_cells_y = 10;
     int mine_count = num_cells_x * num_cells_y * mine_percentage;
     bool no_guess = true;
+    NGSGenerationMode ngs_generation_mode = NGSGenerationMode::LOCAL_REPAIR;
+    FramePacingMode frame_pacing_mode = FramePacingMode::WAIT_EVENTS;
+    const double max_fps = 60.0;
+    // F3 toggles the per phase timings overlay, F4 writes the recent frames here for chrome://tracing
+    const std::string frame_trace_path = "frame_trace.json";
     bool play_field_from_path = false;
     int games_played = 0;
     int games_threshold = 1;
     /*std::string file_path = "assets/minefields/checkerboard.png"; // Change this to your desired path*/
     std::string file_path = "";
 
-    Board board;
+    FlatBoard board;
+    // no-guess boards generated in earlier runs, so replaying a configuration doesn't have to wait on the solver
+    BoardStore board_store("board_cache");
+    // linked programs from earlier runs, so the in-tree renderers don't wait on the driver's compiler every launch
+    set_program_binary_cache_directory("program_binary_cache");
 
     bool uses_file = !file_path.empty();
 
@@ -287,75 +396,136 @@ int main() {
 
         if (extension == "txt") {
             auto pair = read_board_from_file(file_path);
-            board = pair.first;
+            board = to_flat_board(pair.first);
             mine_count = pair.second;
         } else if (extension == "png") {
             auto pair = read_board_from_image_file(file_path);
-            board = pair.first;
+            board = to_flat_board(pair.first);
             mine_count = pair.second;
         } else {
             std::cerr << "Unsupported file format: " << extension << std::endl;
         }
     } else {
-        board = generate_board(mine_count, num_cells_x, num_cells_y);
+        board = generate_flat_board(mine_count, num_cells_x, num_cells_y);
     }
 
-    num_cells_y = board.size();
-    num_cells_x = board[0].size();
+    num_cells_y = board.num_cells_y;
+    num_cells_x = board.num_cells_x;
 
     if (no_guess) {
         if (uses_file) {
-            Solver solver;
+            NGSSolver solver;
             // check if the board is ng solvable
             std::optional<std::pair<int, int>> solution = solver.solve(board, mine_count);
             if (solution.has_value()) {
                 std::cout << "file board is ngs" << std::endl;
                 auto safe_row = solution.value().first;
                 auto safe_col = solution.value().second;
-                board[safe_row][safe_row].safe_start = true;
+                board.set_safe_start(safe_row, safe_col);
             } else {
                 std::cout << "file board is not ngs" << std::endl;
             }
             if (not play_field_from_path) {
                 return 0;
             }
-        } else {
-            board = generate_ng_solvable_board(mine_count, num_cells_x, num_cells_y);
         }
+        // a generated no-guess board isn't solved here, the one that's played is popped from the prefetch queue
+        // when the game starts
     }
 
-    // initialize visuals and sound
+    // leave one core for the render thread, the workers only need to stay ahead of the player.
+    // started before anything else loads so the first board is being solved while the window opens
+    // hardware_concurrency may report 0 when it can't tell, which is treated as a single core
+    unsigned int num_board_threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    BoardPrefetchQueue board_queue(4, num_board_threads, &board_store);
+    board_queue.set_configuration(mine_count, num_cells_x, num_cells_y, no_guess, ngs_generation_mode);
 
-    if (!glfwInit())
-        return -1;
+    std::unordered_map<SoundType, std::string> sound_type_to_file = {
+        {SoundType::FLAG_0, "assets/audio/flag/flag_0.mp3"}, {SoundType::FLAG_1, "assets/audio/flag/flag_1.mp3"},
+        {SoundType::MINE_0, "assets/audio/mine/mine_0.mp3"}, {SoundType::MINE_1, "assets/audio/mine/mine_1.mp3"},
+        {SoundType::MINE_2, "assets/audio/mine/mine_2.mp3"}, {SoundType::MINE_3, "assets/audio/mine/mine_3.mp3"},
+        {SoundType::MINE_4, "assets/audio/mine/mine_4.mp3"}, {SoundType::MINE_5, "assets/audio/mine/mine_5.mp3"},
+        {SoundType::MINE_6, "assets/audio/mine/mine_6.mp3"}, {SoundType::SUCCESS, "assets/audio/success.mp3"},
+        {SoundType::EXPLOSION, "assets/audio/explosion.mp3"}};
 
-    GLFWwindow *window =
-        initialize_glfw_glad_and_return_window(SCREEN_WIDTH, SCREEN_HEIGHT, "cjmines", true, false, false);
+    // rapid chording rarely has more than a handful of sounds overlapping, past this the oldest one is cut off
+    int max_concurrent_sounds = 16;
 
-    GLFWcursor *custom_cursor = create_custom_cursor("assets/crosshair/cross_64.png", 32, 32);
-    if (custom_cursor) {
-        glfwSetCursor(window, custom_cursor);
-    }
+    // anything that doesn't need the gl context is loaded in the background while the window opens and the shaders
+    // compile. the menus need none of it, the game waits on whatever isn't done yet when it starts
+    std::future<DecodedImage> cursor_image_future = load_in_background(
+        startup_timeline, "decode cursor", [] { return decode_image("assets/crosshair/cross_64.png"); });
+    std::future<std::unique_ptr<PooledSoundSystem>> sound_system_future =
+        load_in_background(startup_timeline, "load sounds", [&] {
+            return std::make_unique<PooledSoundSystem>(max_concurrent_sounds, sound_type_to_file);
+        });
 
-    std::vector<ShaderType> requested_shaders = {ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX,
-                                                 ShaderType::TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT};
-    ShaderCache shader_cache(requested_shaders);
-    Batcher batcher(shader_cache);
+    // initialize visuals and sound
+
+    if (!startup_timeline.time("init glfw", [] { return glfwInit(); }))
+        return -1;
 
-    std::vector<Rectangle> grid_rectangles;
+    GLFWwindow *window = startup_timeline.time("open window", [] {
+        return initialize_glfw_glad_and_return_window(SCREEN_WIDTH, SCREEN_HEIGHT, "cjmines", true, false, false);
+    });
+    // the profiler, renderers, shaders and batchers below all free gl objects when destroyed, so this goes first
+    GlfwTeardown glfw_teardown{window};
+
+    FramePacer frame_pacer(frame_pacing_mode, max_fps);
+    FrameProfiler frame_profiler;
+    // only the render thread's allocations, the board workers and the audio thread allocate on their own schedule
+    std::size_t heap_allocation_count_at_frame_start = get_heap_allocation_count_on_this_thread();
+    std::size_t heap_allocations_last_frame = 0;
+    bool show_profiler_overlay = false;
+
+    // both build their programs through create_shader_program, so after the first launch they come out of the
+    // program binary cache instead of being compiled
+    SDFTextBatcher text_batcher = startup_timeline.time("build text shader", [] { return SDFTextBatcher(); });
+    // the menus' boxes only change on hover or a page change, so they stay on the gpu rather than being rebuffered
+    PersistentBatcher menu_batcher = startup_timeline.time("build menu shader", [] {
+        return PersistentBatcher({ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX});
+    });
+    ChunkedGridRenderer grid_renderer;
+    Camera2D camera;
+    // the camera goes back to the whole board whenever a board of another size comes up
+    int camera_num_cells_x = 0;
+    int camera_num_cells_y = 0;
+    bool middle_mouse_pressed = false;
 
     /*auto copied_colors = original_colors;*/
 
-    FontAtlas font_atlas("assets/fonts/times_64_sdf_atlas_font_info.json", "assets/fonts/times_64_sdf_atlas.json",
-                         "assets/fonts/times_64_sdf_atlas.png", SCREEN_WIDTH, false, true);
+    // the menus are drawn with this, so unlike the game's assets it has to be ready before the first frame. it's
+    // baked by the build from the atlas' jsons and png, so loading it is a memory map and one texture upload
+    SDFFont font = startup_timeline.time(
+        "load font", [] { return SDFFont(BakedFontAtlas("assets/fonts/times_64_sdf_atlas.baked")); });
+    BoardTextureRenderer board_texture_renderer = startup_timeline.time(
+        "upload board texture atlas", [&] { return BoardTextureRenderer(font.get_font_atlas()); });
+
+    // this comes from the background load above, see the start of the game loop
+    std::unique_ptr<PooledSoundSystem> sound_system;
+    bool first_frame_shown = false;
+    bool startup_reported = false;
+
+    std::array<glm::vec3, 9> count_colors;
+    for (unsigned int adjacent_mines = 0; adjacent_mines < count_colors.size(); adjacent_mines++) {
+        auto it = mine_count_to_color.find(adjacent_mines);
+        count_colors[adjacent_mines] = it != mine_count_to_color.end() ? it->second : mine_count_to_color.at(0);
+    }
+    grid_renderer.set_colors(count_colors, unrevelead_cell_color, flagged_cell_color, ngs_start_pos_color);
+    board_texture_renderer.set_colors(count_colors, unrevelead_cell_color, flagged_cell_color, ngs_start_pos_color,
+                                      text_color);
+
+    CellLabelCache cell_label_cache(font);
 
     GameState curr_state = MAIN_MENU;
-    std::unordered_map<GameState, UI> game_state_to_ui = {
-        {MAIN_MENU, create_main_menu(window, font_atlas, curr_state)},
-        {OPTIONS_PAGE, create_options_page(font_atlas, curr_state, board, mine_percentage, num_cells_x, num_cells_y,
-                                           mine_count, grid_rectangles, games_threshold)}};
+    std::unordered_map<GameState, MenuUI> game_state_to_ui = {
+        {MAIN_MENU, create_main_menu(window, font, curr_state)},
+        {OPTIONS_PAGE, create_options_page(font, curr_state, board, mine_percentage, num_cells_x, num_cells_y,
+                                           mine_count, games_threshold, no_guess,
+                                           ngs_generation_mode, board_queue)}};
 
-    std::function<void(unsigned int)> char_callback = [&](unsigned int codepoint) {};
+    // every input can change what is on screen, if only through a hover effect
+    std::function<void(unsigned int)> char_callback = [&](unsigned int codepoint) { frame_pacer.request_redraw(); };
 
     bool user_requested_quit = false;
 
@@ -363,24 +533,21 @@ int main() {
 
     bool left_shift_pressed = false;
 
-    bool flag_all_pressed = false;
-    bool flag_all_pressed_last_tick = false;
-
-    bool unflag_all_pressed = false;
-    bool unflag_all_pressed_last_tick = false;
-
-    bool flag_one_pressed = false;
-    bool flag_one_pressed_last_tick = false;
-
     bool mine_all_pressed = false;
-    bool mine_all_pressed_last_tick = false;
 
-    bool mine_one_pressed = false;
-    bool mine_one_pressed_last_tick = false;
+    double mouse_x, mouse_y;
 
-    bool show_times = false;
+    // cell actions are queued as their input events come in and applied once per tick to the hovered cell
+    std::vector<QueuedCellAction> queued_cell_actions;
+    auto queue_cell_action = [&](CellAction action) {
+        if (curr_state == IN_GAME) {
+            queued_cell_actions.push_back({action, mouse_x, mouse_y});
+        }
+    };
 
     std::function<void(int, int, int, int)> key_callback = [&](int key, int scancode, int action, int mods) {
+        frame_pacer.request_redraw();
+
         if (key == GLFW_KEY_LEFT_SHIFT) {
             if (action == GLFW_PRESS) {
                 left_shift_pressed = true;
@@ -392,48 +559,60 @@ int main() {
 
         if (key == GLFW_KEY_R) {
             if (action == GLFW_PRESS && left_shift_pressed) {
-                unflag_all_pressed = true;
-            }
-            if (action == GLFW_RELEASE) {
-                unflag_all_pressed = false;
+                queue_cell_action(CellAction::UNFLAG);
             }
         }
 
         if (key == GLFW_KEY_F) {
-            if (action == GLFW_PRESS) {
-                if (left_shift_pressed) {
-                    flag_all_pressed = true;
-                } else {
-                    flag_one_pressed = true;
-                }
-            }
-            if (action == GLFW_RELEASE) {
-                flag_all_pressed = false;
-                flag_one_pressed = false;
+            if (action == GLFW_PRESS && left_shift_pressed) {
+                queue_cell_action(CellAction::FLAG);
             }
         }
 
-        if (key == GLFW_KEY_TAB) {
-            if (action == GLFW_PRESS) {
-                show_times = !show_times;
-            }
+        if (key == GLFW_KEY_F3 and action == GLFW_PRESS) {
+            show_profiler_overlay = not show_profiler_overlay;
+        }
+        if (key == GLFW_KEY_F4 and action == GLFW_PRESS) {
+            frame_profiler.write_chrome_trace(frame_trace_path);
         }
+
         if (key == GLFW_KEY_Q) {
             if (action == GLFW_PRESS) {
                 user_requested_quit = true;
             }
         }
         if (key == GLFW_KEY_D) {
-            if (action == GLFW_PRESS) {
-                if (left_shift_pressed) {
-                    mine_one_pressed = true;
-                } else {
-                    mine_all_pressed = true;
-                }
+            if (action == GLFW_PRESS && !left_shift_pressed) {
+                mine_all_pressed = true;
+                queue_cell_action(CellAction::MINE);
             }
             if (action == GLFW_RELEASE) {
                 mine_all_pressed = false;
-                mine_one_pressed = false;
+            }
+        }
+
+        // arrows pan, = and - zoom about the middle of the screen and home shows the whole board again
+        if (curr_state == IN_GAME and (action == GLFW_PRESS or action == GLFW_REPEAT)) {
+            if (key == GLFW_KEY_LEFT) {
+                camera.pan_by_ndc(glm::vec2(2 * camera_pan_step, 0));
+            }
+            if (key == GLFW_KEY_RIGHT) {
+                camera.pan_by_ndc(glm::vec2(-2 * camera_pan_step, 0));
+            }
+            if (key == GLFW_KEY_UP) {
+                camera.pan_by_ndc(glm::vec2(0, -2 * camera_pan_step));
+            }
+            if (key == GLFW_KEY_DOWN) {
+                camera.pan_by_ndc(glm::vec2(0, 2 * camera_pan_step));
+            }
+            if (key == GLFW_KEY_EQUAL) {
+                camera.zoom_about(glm::vec2(0, 0), camera_zoom_step);
+            }
+            if (key == GLFW_KEY_MINUS) {
+                camera.zoom_about(glm::vec2(0, 0), 1 / camera_zoom_step);
+            }
+            if (key == GLFW_KEY_HOME) {
+                camera.reset();
             }
         }
 
@@ -446,47 +625,45 @@ int main() {
             game_state_to_ui.at(curr_state).process_confirm_action();
     };
 
-    double mouse_x, mouse_y;
-
     std::function<void(double, double)> mouse_callback = [&](double xpos, double ypos) {
+        frame_pacer.request_redraw();
+        if (middle_mouse_pressed) {
+            int window_width, window_height;
+            glfwGetWindowSize(window, &window_width, &window_height);
+            auto [previous_ndc_x, previous_ndc_y] = convert_mouse_to_ndc(mouse_x, mouse_y, window_width, window_height);
+            auto [ndc_x, ndc_y] = convert_mouse_to_ndc(xpos, ypos, window_width, window_height);
+            camera.pan_by_ndc(glm::vec2(ndc_x - previous_ndc_x, ndc_y - previous_ndc_y));
+        }
         mouse_x = xpos;
         mouse_y = ypos;
     };
 
     bool lmb_pressed = false;
     bool lmb_pressed_last_tick = false;
-    bool rmb_pressed = false;
-    bool rmb_pressed_last_tick = false;
 
     std::function<void(int, int, int)> mouse_button_callback = [&](int button, int action, int mods) {
+        frame_pacer.request_redraw();
+
         if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
             lmb_pressed = true;
+            queue_cell_action(CellAction::MINE);
         } else if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE) {
             lmb_pressed = false;
         }
 
         if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
-            rmb_pressed = true;
-        } else if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_RELEASE) {
-            rmb_pressed = false;
+            queue_cell_action(CellAction::FLAG);
+        }
+
+        // dragging with the middle button pans the board
+        if (button == GLFW_MOUSE_BUTTON_MIDDLE) {
+            middle_mouse_pressed = action == GLFW_PRESS and curr_state == IN_GAME;
         }
     };
 
     GLFWLambdaCallbackManager window_callback_manager(window, char_callback, key_callback, mouse_callback,
                                                       mouse_button_callback);
 
-    std::unordered_map<SoundType, std::string> sound_type_to_file = {
-        {SoundType::FLAG_0, "assets/audio/flag/flag_0.mp3"}, {SoundType::FLAG_1, "assets/audio/flag/flag_1.mp3"},
-        {SoundType::MINE_0, "assets/audio/mine/mine_0.mp3"}, {SoundType::MINE_1, "assets/audio/mine/mine_1.mp3"},
-        {SoundType::MINE_2, "assets/audio/mine/mine_2.mp3"}, {SoundType::MINE_3, "assets/audio/mine/mine_3.mp3"},
-        {SoundType::MINE_4, "assets/audio/mine/mine_4.mp3"}, {SoundType::MINE_5, "assets/audio/mine/mine_5.mp3"},
-        {SoundType::MINE_6, "assets/audio/mine/mine_6.mp3"}, {SoundType::SUCCESS, "assets/audio/success.mp3"},
-        {SoundType::EXPLOSION, "assets/audio/explosion.mp3"}};
-
-    int max_concurrent_sounds = 100;
-
-    SoundSystem sound_system(max_concurrent_sounds, sound_type_to_file);
-
     /*sound_system.load_sound_into_system_for_playback("mine", "assets/audio/mine/output_12.mp3");*/
     /*sound_system.load_sound_into_system_for_playback("flag", "assets/audio/flag/flag_0.mp3");*/
     /*sound_system.load_sound_into_system_for_playback("success", "assets/audio/success.mp3");*/
@@ -503,41 +680,62 @@ int main() {
     float char_width = 0.5;
     float edge_transition = 0.1;
 
-    shader_cache.use_shader_program(ShaderType::TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT);
-    shader_cache.set_uniform(ShaderType::TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT, ShaderUniformVariable::TRANSFORM,
-                             projection);
-
-    shader_cache.set_uniform(ShaderType::TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT, ShaderUniformVariable::RGB_COLOR,
-                             text_color);
-
-    shader_cache.set_uniform(ShaderType::TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT,
-                             ShaderUniformVariable::CHARACTER_WIDTH, char_width);
-
-    shader_cache.set_uniform(ShaderType::TRANSFORM_V_WITH_SIGNED_DISTANCE_FIELD_TEXT,
-                             ShaderUniformVariable::EDGE_TRANSITION_WIDTH, edge_transition);
+    text_batcher.set_transform(projection);
+    text_batcher.set_style(text_color, char_width, edge_transition);
 
     double previous_time = glfwGetTime();
     int frame_count = 0;
     float fps = 0;
+    SDFTextMesh fps_text_mesh = font.generate_text_mesh_size_constraints("FPS: 0.0", 0.9, 0.9, 0.15, 0.15);
+    std::vector<SDFTextMesh> profiler_overlay_meshes;
+    // remaining mines and how much of the board is cleared, laid out again only when either changes
+    SDFTextMesh board_status_text_mesh;
+    int shown_mines_left = -1;
+    int shown_cleared_percent = -1;
 
     bool sucessfully_mined = true;
 
-    const double max_fps = 60.0;
-    const double max_frame_time = 1.0 / max_fps;
-
     double game_start_time = 0;
     bool game_started = false;
     std::vector<double> game_times;
     double total_time = 0.0;
 
+    // false after the pacer woke up with nothing new to show, those wakes only look at the background loads
+    bool redraw_due = true;
+
     // Main game loop
     while (!glfwWindowShouldClose(window) and !user_requested_quit) {
+        // background loads are picked up as soon as they finish, or waited on once the game needs them
+        if (cursor_image_future.valid() and is_ready(cursor_image_future)) {
+            DecodedImage cursor_image = cursor_image_future.get();
+            GLFWcursor *custom_cursor = create_custom_cursor(cursor_image, 32, 32);
+            if (custom_cursor) {
+                glfwSetCursor(window, custom_cursor);
+            }
+        }
+        if (sound_system_future.valid() and (curr_state == IN_GAME or is_ready(sound_system_future))) {
+            try {
+                sound_system = startup_timeline.time("wait for sounds", [&] { return sound_system_future.get(); });
+            } catch (const std::exception &e) {
+                // no audio device or a sound that failed to decode shouldn't stop the game, it just plays silently
+                std::cerr << "couldn't start the sound system, continuing without sound: " << e.what() << std::endl;
+            }
+        }
+
+        if (not redraw_due) {
+            redraw_due = frame_pacer.end_frame();
+            continue;
+        }
 
-        double frame_start_time = glfwGetTime();
+        frame_profiler.begin_frame();
+        std::size_t heap_allocation_count = get_heap_allocation_count_on_this_thread();
+        heap_allocations_last_frame = heap_allocation_count - heap_allocation_count_at_frame_start;
+        heap_allocation_count_at_frame_start = heap_allocation_count;
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         if (curr_state != IN_GAME) {
+            frame_profiler.begin_phase("ui");
             auto ndc_mouse_pos = convert_mouse_to_ndc(mouse_x, mouse_y, SCREEN_WIDTH, SCREEN_HEIGHT);
             auto &curr_ui = game_state_to_ui.at(curr_state);
 
@@ -550,35 +748,49 @@ int main() {
 
             process_key_pressed_this_tick(curr_ui, key_pressed_this_tick);
 
+            // a box keeps its id for as long as the page is up, so only the boxes that changed are uploaded again.
+            // another page reuses the same ids, which is still only an upload of the boxes that differ
+            unsigned int menu_box_id = 0;
             for (auto &tb : curr_ui.get_text_boxes()) {
-                batcher.transform_v_with_signed_distance_field_text_shader_batcher.queue_draw(
-                    tb.text_drawing_data.indices, tb.text_drawing_data.xyz_positions,
-                    tb.text_drawing_data.texture_coordinates);
-                batcher.absolute_position_with_colored_vertex_shader_batcher.queue_draw(
-                    tb.background_ivpsc.indices, tb.background_ivpsc.xyz_positions, tb.background_ivpsc.rgb_colors);
+                text_batcher.queue_draw(
+                    tb.text_mesh.indices, tb.text_mesh.vertex_positions, tb.text_mesh.texture_coordinates);
+                menu_batcher.queue_draw(menu_box_id++, tb.background.xyz_positions, tb.background.rgb_colors,
+                                        tb.background.indices,
+                                        ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX);
             }
 
             for (auto &cr : curr_ui.get_clickable_text_boxes()) {
-                batcher.transform_v_with_signed_distance_field_text_shader_batcher.queue_draw(
-                    cr.text_drawing_data.indices, cr.text_drawing_data.xyz_positions,
-                    cr.text_drawing_data.texture_coordinates);
-                batcher.absolute_position_with_colored_vertex_shader_batcher.queue_draw(
-                    cr.ivpsc.indices, cr.ivpsc.xyz_positions, cr.ivpsc.rgb_colors);
+                text_batcher.queue_draw(
+                    cr.text_mesh.indices, cr.text_mesh.vertex_positions, cr.text_mesh.texture_coordinates);
+                menu_batcher.queue_draw(menu_box_id++, cr.background.xyz_positions, cr.background.rgb_colors,
+                                        cr.background.indices,
+                                        ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX);
             }
 
             for (auto &ib : curr_ui.get_input_boxes()) {
-                batcher.transform_v_with_signed_distance_field_text_shader_batcher.queue_draw(
-                    ib.text_drawing_data.indices, ib.text_drawing_data.xyz_positions,
-                    ib.text_drawing_data.texture_coordinates);
-                batcher.absolute_position_with_colored_vertex_shader_batcher.queue_draw(
-                    ib.background_ivpsc.indices, ib.background_ivpsc.xyz_positions, ib.background_ivpsc.rgb_colors);
+                text_batcher.queue_draw(
+                    ib.text_mesh.indices, ib.text_mesh.vertex_positions, ib.text_mesh.texture_coordinates);
+                menu_batcher.queue_draw(menu_box_id++, ib.background.xyz_positions, ib.background.rgb_colors,
+                                        ib.background.indices,
+                                        ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX);
             }
 
-            batcher.absolute_position_with_colored_vertex_shader_batcher.draw_everything();
-            batcher.transform_v_with_signed_distance_field_text_shader_batcher.draw_everything();
+            frame_profiler.end_phase();
+
+            frame_profiler.begin_phase("draw_everything");
+            frame_profiler.begin_gpu_phase("draw");
+            // the boxes go first so the text is drawn over them
+            menu_batcher.draw_everything();
+            font.bind_texture();
+            text_batcher.draw_everything();
+            frame_profiler.end_gpu_phase();
+            frame_profiler.end_phase();
 
         } else {
             // clang-format off
+        // a win that ends the round continues straight to the next frame, begin_frame closes this phase then
+        frame_profiler.begin_phase("board logic");
+
         // Start the game time when the first move is made
         if (!game_started && (lmb_pressed || mine_all_pressed)) {
             game_start_time = glfwGetTime();
@@ -588,7 +800,9 @@ int main() {
         if (field_clear(board)) {
             game_started = false;
             std::cout << "field was clear" << std::endl;
-                sound_system.queue_sound(SoundType::SUCCESS, center);
+            if (sound_system) {
+                sound_system->queue_sound(SoundType::SUCCESS, center);
+            }
 
             // Calculate elapsed time and store it
             double game_time = glfwGetTime() - game_start_time;
@@ -608,22 +822,22 @@ int main() {
 
                 std::cout << avg_time << "\n";
                 game_times.clear();
-                game_state_to_ui.insert_or_assign(END_GAME, create_ending_page(window, font_atlas, curr_state, avg_time));
+                game_state_to_ui.insert_or_assign(END_GAME, create_ending_page(window, font, curr_state, avg_time));
                 curr_state = END_GAME;
                 game_started = false;
+                frame_pacer.request_redraw();
                 continue;
             }
 
-            // Generate a new board after winning
-            if (no_guess) {
-                board = generate_ng_solvable_board(mine_count, num_cells_x, num_cells_y);
-            } else {
-                board = generate_board(mine_count, num_cells_x, num_cells_y);
-            }
+            // Take the next prefetched board after winning
+            board = board_queue.pop();
+            frame_pacer.request_redraw();
         }
 
         if (!sucessfully_mined) {
-                sound_system.queue_sound(SoundType::EXPLOSION, center);
+            if (sound_system) {
+                sound_system->queue_sound(SoundType::EXPLOSION, center);
+            }
             std::cout << "you died" << std::endl;
 
             // Calculate elapsed time and store it
@@ -636,190 +850,219 @@ int main() {
 
             game_started = false; // Reset game start flag for the next game
 
-            // Generate a new board after losing
-            if (no_guess) {
-                board = generate_ng_solvable_board(mine_count, num_cells_x, num_cells_y);
-            } else {
-                board = generate_board(mine_count, num_cells_x, num_cells_y);
-            }
+            // Take the next prefetched board after losing
+            board = board_queue.pop();
+            frame_pacer.request_redraw();
             sucessfully_mined = true;
         }
+        frame_profiler.end_phase();
 
         // FPS calculation
         double current_time = glfwGetTime();
         frame_count++;
         if (current_time - previous_time >= 1.0) { // Update every second
             fps = frame_count / (current_time - previous_time);
+
+            // the fps text only changes here so it is only laid out here
+            ScopedPhaseTimer text_timer(frame_profiler, "text generation");
+            // short enough to stay in the string's small buffer, only the mesh itself touches the heap
+            char fps_text[32];
+            std::snprintf(fps_text, sizeof(fps_text), "FPS: %.1f", fps);
+            fps_text_mesh = font.generate_text_mesh_size_constraints(fps_text, 0.9, 0.9, 0.15, 0.15);
             previous_time = current_time;
             frame_count = 0;
+
+            if (show_profiler_overlay) {
+                profiler_overlay_meshes =
+                    create_profiler_overlay(font, frame_profiler, heap_allocations_last_frame);
+            }
+        }
+        int mines_left = board.get_mine_count() - board.get_flag_count();
+        int safe_cells = board.num_cells_x * board.num_cells_y - board.get_mine_count();
+        int cleared_percent =
+            safe_cells == 0 ? 100 : 100 * (safe_cells - board.get_unrevealed_safe_count()) / safe_cells;
+        if (mines_left != shown_mines_left or cleared_percent != shown_cleared_percent) {
+            ScopedPhaseTimer text_timer(frame_profiler, "text generation");
+            char status_text[48];
+            std::snprintf(status_text, sizeof(status_text), "mines: %d  %d%%", mines_left, cleared_percent);
+            board_status_text_mesh =
+                font.generate_text_mesh_size_constraints(status_text, 0.8, 0.78, 0.35, 0.1);
+            shown_mines_left = mines_left;
+            shown_cleared_percent = cleared_percent;
+        }
+
+        if (not show_profiler_overlay) {
+            profiler_overlay_meshes.clear();
+        } else if (profiler_overlay_meshes.empty()) {
+            // just toggled on, don't wait for the next fps update to show something
+            ScopedPhaseTimer text_timer(frame_profiler, "text generation");
+            profiler_overlay_meshes =
+                create_profiler_overlay(font, frame_profiler, heap_allocations_last_frame);
         }
 
         int current_width, current_height;
         glfwGetWindowSize(window, &current_width, &current_height);
+        // what's drawn is measured in framebuffer pixels, the cursor in window coordinates, on high dpi displays
+        // they differ
+        int framebuffer_width, framebuffer_height;
+        glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
 
         float aspect_ratio = (float)current_width / (float)current_height;
-        aspect_ratio = 1;
-
-        auto [ndc_x, ndc_y] = convert_mouse_to_ndc(mouse_x, mouse_y, current_width, current_height);
-        glm::vec3 cursor_pos(ndc_x, ndc_y, 0);
-
-        shader_cache.use_shader_program(ShaderType::ABSOLUTE_POSITION_WITH_COLORED_VERTEX);
-
-        unsigned int flat_idx = 0;
-        for (const auto &row : board) {
-            for (const auto &cell : row) {
-                Rectangle graphical_rect = grid_rectangles.at(flat_idx);
-
-                std::vector<glm::vec3> rectangle_vertices = generate_rectangle_vertices(
-                    graphical_rect.center.x, graphical_rect.center.y, graphical_rect.width, graphical_rect.height);
-                std::vector<unsigned int> rectangle_indices = generate_rectangle_indices();
-
-                std::string text;
-                glm::vec3 rectangle_color;
-                if (cell.is_revealed) {
-                    text = std::to_string(cell.adjacent_mines);
-                    rectangle_color = mine_count_to_color.at(cell.adjacent_mines);
-                } else if (cell.is_flagged) {
-                    text = "F";
-                    rectangle_color = flagged_cell_color;
-                } else if (cell.safe_start) {
-                    text = "X";
-                    rectangle_color = ngs_start_pos_color;
+        camera.set_aspect_ratio(aspect_ratio);
+
+        GridLayout world_grid_layout = create_grid_layout(board.num_cells_x, board.num_cells_y);
+        if (board.num_cells_x != camera_num_cells_x or board.num_cells_y != camera_num_cells_y) {
+            // zooming in stops once a cell spans half the screen's height
+            float max_zoom = 1 / std::max(world_grid_layout.cell_pitch.x, 0.001f);
+            camera.set_zoom_limits(0.5, std::max(1.0f, max_zoom));
+            camera.reset();
+            camera_num_cells_x = board.num_cells_x;
+            camera_num_cells_y = board.num_cells_y;
+        }
+        // the board as it is on screen, everything below draws and hit tests against this
+        GridLayout grid_layout = camera.world_to_ndc(world_grid_layout);
+
+        frame_profiler.begin_phase("input");
+        for (const auto &queued : queued_cell_actions) {
+            auto [ndc_x, ndc_y] = convert_mouse_to_ndc(queued.mouse_x, queued.mouse_y, current_width, current_height);
+            auto cell = grid_layout.get_cell_at(glm::vec2(ndc_x, ndc_y));
+            if (not cell.has_value()) {
+                continue;
+            }
+            auto [row_idx, col_idx] = cell.value();
+
+            if (queued.action == CellAction::MINE) {
+                if (!board.is_revealed(row_idx, col_idx)) {
+                    std::cout << "mining one" << std::endl;
+                    sucessfully_mined = reveal_cell(board, row_idx, col_idx);
                 } else {
-                    text = "";
-                    rectangle_color = unrevelead_cell_color;
+                    std::cout << "mining all" << std::endl;
+                    sucessfully_mined = reveal_adjacent_cells(board, row_idx, col_idx);
                 }
-
-                if (text != "" && text != "0") {
-                    TextMesh text_mesh = font_atlas.generate_text_mesh_size_constraints(text, graphical_rect.center.x, graphical_rect.center.y, graphical_rect.width * 0.5, graphical_rect.height * 0.5);
-                    batcher.transform_v_with_signed_distance_field_text_shader_batcher.queue_draw(text_mesh.indices, text_mesh.vertex_positions, text_mesh.texture_coordinates);
+                    // todo use positional sound based on row and col idx later
+                if (sound_system) {
+                    sound_system->queue_sound(get_random_mine_sound(), center);
                 }
+                if (!sucessfully_mined) {
+                    // the rest of this tick's input was meant for the board that just blew up
+                    break;
+                }
+            }
 
-                std::vector<glm::vec3> rectangle_colors = generate_colors_for_indices({rectangle_color});
-                batcher.absolute_position_with_colored_vertex_shader_batcher.queue_draw(
-                    rectangle_indices, rectangle_vertices, rectangle_colors);
-
-                if (is_point_in_rectangle(graphical_rect, cursor_pos)) {
-                    bool trying_to_mine_all =
-                        (lmb_pressed && !lmb_pressed_last_tick) || (mine_all_pressed && !mine_all_pressed_last_tick);
-
-                    bool trying_to_flag_all =
-                        (rmb_pressed && !rmb_pressed_last_tick) || (flag_all_pressed && !flag_all_pressed_last_tick);
-
-                    bool trying_to_unflag_all = unflag_all_pressed && !unflag_all_pressed_last_tick;
-
-                    if (trying_to_mine_all) {
-                        int row_idx = flat_idx / row.size();
-                        int col_idx = flat_idx % row.size();
-
-                        if (!cell.is_revealed) {
-                            std::cout << "mining one" << std::endl;
-                            sucessfully_mined = reveal_cell(board, row_idx, col_idx);
-                        } else {
-                            std::cout << "mining all" << std::endl;
-                            sucessfully_mined = reveal_adjacent_cells(board, row_idx, col_idx);
-                        }
-                            // todo use positional sound based on row and col idx later
-                        sound_system.queue_sound(get_random_mine_sound(), center);
-                    }
+            if (queued.action == CellAction::FLAG) {
+                if (!board.is_revealed(row_idx, col_idx)) {
+                    std::cout << "flagging one" << std::endl;
+                    toggle_flag_cell(board, row_idx, col_idx);
+                } else {
+                    std::cout << "flagging all" << std::endl;
+                    set_adjacent_cells_flags(board, row_idx, col_idx, true);
+                }
+                if (sound_system) {
+                    sound_system->queue_sound(get_random_flag_sound(), center);
+                }
+            }
 
-                    if (trying_to_flag_all) {
-                        int row_idx = flat_idx / row.size();
-                        int col_idx = flat_idx % row.size();
-                        if (!cell.is_revealed) {
-                            std::cout << "flagging one" << std::endl;
-                            toggle_flag_cell(board, row_idx, col_idx);
-                        } else {
-                            std::cout << "flagging all" << std::endl;
-                            set_adjacent_cells_flags(board, row_idx, col_idx, true);
+            if (queued.action == CellAction::UNFLAG) {
+                std::cout << "unflagging all" << std::endl;
+                set_adjacent_cells_flags(board, row_idx, col_idx, false);
+                // sound_system.play_sound("cell", "unflag");
+            }
+        }
+        if (not queued_cell_actions.empty()) {
+            // win and loss are only noticed at the start of a tick, so make sure there is another one
+            frame_pacer.request_redraw();
+        }
+        queued_cell_actions.clear();
+        frame_profiler.end_phase();
+
+        // ndc spans two units across the screen
+        float cell_pixels = grid_layout.cell_size.y * framebuffer_height * 0.5f;
+        bool draw_board_as_texture = cell_pixels < board_texture_max_cell_pixels;
+
+        frame_profiler.begin_phase("queue_draw");
+        if (not draw_board_as_texture and cell_pixels >= cell_label_min_cell_pixels) {
+            // every cell is the same size, labels take up the middle half of it
+            cell_label_cache.set_label_size(grid_layout.cell_size.x * 0.5, grid_layout.cell_size.y * 0.5);
+
+            // only the cells on screen get a label, the cells themselves are drawn from their chunks
+            CellRange visible_cells = grid_layout.get_cells_overlapping(glm::vec2(-1, -1), glm::vec2(1, 1));
+            for (int row_idx = visible_cells.min_row; row_idx <= visible_cells.max_row; row_idx++) {
+                for (int col_idx = visible_cells.min_col; col_idx <= visible_cells.max_col; col_idx++) {
+                    // -1 for cells without a label
+                    int label = -1;
+                    if (board.is_revealed(row_idx, col_idx)) {
+                        int adjacent_mines = board.get_adjacent_mines(row_idx, col_idx);
+                        if (adjacent_mines > 0) {
+                            label = CellLabelCache::get_count_label(adjacent_mines);
                         }
-                        sound_system.queue_sound(get_random_flag_sound(), center);
+                    } else if (board.is_flagged(row_idx, col_idx)) {
+                        label = CellLabelCache::FLAG_LABEL;
+                    } else if (board.is_safe_start(row_idx, col_idx)) {
+                        label = CellLabelCache::SAFE_START_LABEL;
                     }
 
-                    if (trying_to_unflag_all) {
-                        int row_idx = flat_idx / row.size();
-                        int col_idx = flat_idx % row.size();
-                        std::cout << "unflagging all" << std::endl;
-                        set_adjacent_cells_flags(board, row_idx, col_idx, false);
-                        // sound_system.play_sound("cell", "unflag");
+                    if (label >= 0) {
+                        glm::vec2 cell_center = grid_layout.first_cell_center + glm::vec2(col_idx, row_idx) * grid_layout.cell_pitch;
+                        SDFTextMesh &label_mesh = cell_label_cache.get_mesh(label);
+                        text_batcher.queue_draw(label_mesh.indices, cell_label_cache.get_positions_at(label, cell_center.x, cell_center.y), label_mesh.texture_coordinates);
                     }
                 }
-                flat_idx += 1;
             }
         }
 
         // Render FPS
-        std::stringstream fps_ss;
-        fps_ss << "FPS: " << std::fixed << std::setprecision(1) << fps;
-        std::string fps_text = fps_ss.str();
-        TextMesh fps_text_mesh = font_atlas.generate_text_mesh_size_constraints(fps_text, 0.9, 0.9, 0.15, 0.15);
-        batcher.transform_v_with_signed_distance_field_text_shader_batcher.queue_draw(fps_text_mesh.indices, fps_text_mesh.vertex_positions, fps_text_mesh.texture_coordinates);
-
-        batcher.absolute_position_with_colored_vertex_shader_batcher.draw_everything();
-        batcher.transform_v_with_signed_distance_field_text_shader_batcher.draw_everything();
-
-        // Render elapsed times and average at the top left of the screen
-        if (!game_times.empty()) {
-            double average_time = total_time / games_played;
-
-            std::stringstream ss;
-            ss << "avg: " << std::fixed << std::setprecision(2) << average_time << "s\n";
-            for (size_t i = 0; i < game_times.size(); ++i) {
-                ss << "t" << i + 1 << ": " << std::fixed << std::setprecision(2) << game_times[i] << "s\n";
-            }
+        text_batcher.queue_draw(fps_text_mesh.indices, fps_text_mesh.vertex_positions, fps_text_mesh.texture_coordinates);
+        text_batcher.queue_draw(board_status_text_mesh.indices, board_status_text_mesh.vertex_positions, board_status_text_mesh.texture_coordinates);
+        for (const auto &overlay_line : profiler_overlay_meshes) {
+            text_batcher.queue_draw(overlay_line.indices, overlay_line.vertex_positions, overlay_line.texture_coordinates);
+        }
+        frame_profiler.end_phase();
 
-            std::string times_text = ss.str();
-
-            // Split the string by newlines
-            std::istringstream stream(times_text);
-            std::string line;
-            float margin = 0.1;
-            glm::vec2 start_pos = glm::vec2(-0.8f, 1.0f); // Top-left corner of the screen
-            glm::vec2 current_pos = start_pos;
-
-            // int line_count = 0;
-            // // Loop through each line and render it
-            // while (std::getline(stream, line)) {
-            //     if (not show_times) {
-            //         if (line_count >= 1) {
-            //             break;
-            //         }
-            //     }
-            //     // Get the dimensions of the current line
-            //     glm::vec2 line_dims = text_renderer.get_text_dimensions_in_ndc(line, 1);
-
-            //     // Render the current line at the current position
-            //     text_renderer.render_text(line, current_pos - glm::vec2(0.0f, line_dims.y), 1, {1, 0, 0});
-
-            //     // Move the current position down by the height of the current line
-            //     current_pos.y -= (line_dims.y + margin);
-            //     line_count++;
-            // }
-                // clang-format on
-            }
+        if (draw_board_as_texture) {
+            ScopedPhaseTimer upload_timer(frame_profiler, "board upload");
+            board_texture_renderer.set_layout(grid_layout);
+            board_texture_renderer.update(board);
+        } else {
+            ScopedPhaseTimer upload_timer(frame_profiler, "board upload");
+            grid_renderer.update(board);
         }
 
-        lmb_pressed_last_tick = lmb_pressed;
-        rmb_pressed_last_tick = rmb_pressed;
-        flag_all_pressed_last_tick = flag_all_pressed;
-        flag_one_pressed_last_tick = flag_one_pressed;
-        mine_all_pressed_last_tick = mine_all_pressed;
-        mine_one_pressed_last_tick = mine_one_pressed;
+        frame_profiler.begin_phase("draw_everything");
+        frame_profiler.begin_gpu_phase("draw");
+        if (draw_board_as_texture) {
+            board_texture_renderer.draw(framebuffer_width, framebuffer_height);
+        } else {
+            grid_renderer.draw(grid_layout);
+        }
+        // the board renderers bind their own textures, so the font's goes back before the text
+        font.bind_texture();
+        text_batcher.draw_everything();
+        frame_profiler.end_gpu_phase();
+        frame_profiler.end_phase();
+            // clang-format on
+        }
 
-        sound_system.play_all_sounds();
+        lmb_pressed_last_tick = lmb_pressed;
 
+        frame_profiler.begin_phase("swap");
         glfwSwapBuffers(window);
-        glfwPollEvents();
-
-        // Frame limiting
-        double frame_end_time = glfwGetTime();
-        double frame_duration = frame_end_time - frame_start_time;
-        if (frame_duration < max_frame_time) {
-            // std::this_thread::sleep_for(std::chrono::duration<double>(max_frame_time - frame_duration));
+        frame_profiler.end_phase();
+        if (not first_frame_shown) {
+            startup_timeline.mark("first frame");
+            first_frame_shown = true;
         }
+        // reported once whatever was loading in the background has been picked up too, so no step is missing
+        if (not startup_reported and not cursor_image_future.valid() and not sound_system_future.valid()) {
+            startup_timeline.print_report();
+            startup_reported = true;
+        }
+
+        // input callbacks run in here, along with any waiting for the next frame
+        frame_profiler.begin_phase("events and pacing");
+        redraw_due = frame_pacer.end_frame();
+        frame_profiler.end_phase();
+        frame_profiler.end_frame();
     }
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
     return 0;
 }
@@ -0,0 +1,168 @@
+#include "ngs_generator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::mt19937 &get_thread_rng() {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return rng;
+}
+
+template <typename T> const T &pick_random(const std::vector<T> &items, std::mt19937 &rng) {
+    std::uniform_int_distribution<std::size_t> dist(0, items.size() - 1);
+    return items[dist(rng)];
+}
+
+void move_mine(FlatBoard &board, std::pair<int, int> from, std::pair<int, int> to) {
+    board.remove_mine(from.first, from.second);
+    board.place_mine(to.first, to.second);
+}
+
+/**
+ * @brief Moves every mine out of the 3x3 block around the start so the first reveal opens up an area.
+ * @return false if there are not enough free cells outside the block to hold the mines.
+ */
+bool clear_start_area(FlatBoard &board, int start_row, int start_col, std::mt19937 &rng) {
+    auto in_start_area = [&](int r, int c) { return std::abs(r - start_row) <= 1 and std::abs(c - start_col) <= 1; };
+
+    std::vector<std::pair<int, int>> mines_to_move;
+    std::vector<std::pair<int, int>> free_cells;
+    for (int r = 0; r < board.num_cells_y; r++) {
+        for (int c = 0; c < board.num_cells_x; c++) {
+            if (in_start_area(r, c)) {
+                if (board.is_mine(r, c)) {
+                    mines_to_move.emplace_back(r, c);
+                }
+            } else if (not board.is_mine(r, c)) {
+                free_cells.emplace_back(r, c);
+            }
+        }
+    }
+    if (mines_to_move.size() > free_cells.size()) {
+        return false;
+    }
+
+    std::shuffle(free_cells.begin(), free_cells.end(), rng);
+    for (std::size_t i = 0; i < mines_to_move.size(); i++) {
+        move_mine(board, mines_to_move[i], free_cells[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Moves a single mine between the frontier and the interior to give a stuck solver something new to work with.
+ * @return false if neither direction is possible.
+ */
+bool repair_frontier(FlatBoard &board, NGSSolver &solver, std::mt19937 &rng) {
+    std::vector<std::pair<int, int>> frontier_mines, frontier_safe, interior_mines, interior_safe;
+    for (const auto &[r, c] : solver.get_frontier()) {
+        (board.is_mine(r, c) ? frontier_mines : frontier_safe).emplace_back(r, c);
+    }
+    for (const auto &[r, c] : solver.get_interior()) {
+        (board.is_mine(r, c) ? interior_mines : interior_safe).emplace_back(r, c);
+    }
+
+    std::pair<int, int> from, to;
+    if (not frontier_mines.empty() and not interior_safe.empty()) {
+        from = pick_random(frontier_mines, rng);
+        to = pick_random(interior_safe, rng);
+    } else if (not frontier_safe.empty() and not interior_mines.empty()) {
+        from = pick_random(interior_mines, rng);
+        to = pick_random(frontier_safe, rng);
+    } else {
+        return false;
+    }
+
+    move_mine(board, from, to);
+    // only the numbers around the two changed cells need another look
+    solver.mark_dirty_around(from.first, from.second);
+    solver.mark_dirty_around(to.first, to.second);
+    return true;
+}
+
+} // namespace
+
+bool can_generate_board(int mine_count, int num_cells_x, int num_cells_y, bool no_guess,
+                        NGSGenerationMode generation_mode) {
+    if (num_cells_x <= 0 or num_cells_y <= 0 or mine_count < 0) {
+        return false;
+    }
+    int num_cells = num_cells_x * num_cells_y;
+    if (no_guess and generation_mode == NGSGenerationMode::LOCAL_REPAIR) {
+        int largest_start_area = std::min(3, num_cells_x) * std::min(3, num_cells_y);
+        return mine_count <= num_cells - largest_start_area;
+    }
+    return mine_count < num_cells;
+}
+
+std::optional<FlatBoard> try_generate_ng_solvable_board(NGSSolver &solver, int mine_count, int num_cells_x,
+                                                        int num_cells_y, const std::atomic<bool> &stop) {
+    return try_generate_ng_solvable_board(solver, mine_count, num_cells_x, num_cells_y, get_thread_rng(), stop);
+}
+
+std::optional<FlatBoard> try_generate_ng_solvable_board(NGSSolver &solver, int mine_count, int num_cells_x,
+                                                        int num_cells_y, std::mt19937 &rng,
+                                                        const std::atomic<bool> &stop) {
+    FlatBoard board = generate_flat_board(mine_count, num_cells_x, num_cells_y, rng);
+    std::optional<std::pair<int, int>> solution = solver.solve(board, mine_count, stop);
+    if (not solution.has_value()) {
+        return std::nullopt;
+    }
+
+    auto [row, col] = solution.value();
+    board.set_safe_start(row, col);
+    return board;
+}
+
+std::optional<FlatBoard> try_generate_ng_solvable_board_with_local_repair(NGSSolver &solver, int mine_count,
+                                                                          int num_cells_x, int num_cells_y,
+                                                                          const std::atomic<bool> &stop) {
+    return try_generate_ng_solvable_board_with_local_repair(solver, mine_count, num_cells_x, num_cells_y,
+                                                            get_thread_rng(), stop);
+}
+
+std::optional<FlatBoard> try_generate_ng_solvable_board_with_local_repair(NGSSolver &solver, int mine_count,
+                                                                          int num_cells_x, int num_cells_y,
+                                                                          std::mt19937 &rng,
+                                                                          const std::atomic<bool> &stop) {
+    FlatBoard board = generate_flat_board(mine_count, num_cells_x, num_cells_y, rng);
+
+    std::uniform_int_distribution<int> row_dist(0, num_cells_y - 1);
+    std::uniform_int_distribution<int> col_dist(0, num_cells_x - 1);
+    int start_row = row_dist(rng);
+    int start_col = col_dist(rng);
+    if (not clear_start_area(board, start_row, start_col, rng)) {
+        return std::nullopt;
+    }
+
+    solver.reset(board, mine_count);
+    solver.reveal_start(start_row, start_col);
+
+    // every repair moves one mine, beyond this many the board is unlikely to converge and a reroll is cheaper
+    const int max_repairs = num_cells_x * num_cells_y;
+    for (int repairs = 0; repairs <= max_repairs; repairs++) {
+        if (stop.load(std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        if (solver.propagate(stop)) {
+            // knowledge gathered before a repair may no longer be derivable afterwards, so check from scratch
+            solver.reset(board, mine_count);
+            solver.reveal_start(start_row, start_col);
+            if (solver.propagate(stop)) {
+                board.set_safe_start(start_row, start_col);
+                return board;
+            }
+            continue;
+        }
+
+        if (not repair_frontier(board, solver, rng)) {
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,60 @@
+#ifndef NGS_GENERATOR_HPP
+#define NGS_GENERATOR_HPP
+
+#include <atomic>
+#include <optional>
+#include <random>
+
+#include "../flat_board/flat_board.hpp"
+#include "../ngs_solver/ngs_solver.hpp"
+
+enum class NGSGenerationMode {
+    // reroll the whole board every time the solver fails
+    REJECTION_SAMPLING,
+    // keep the partially solved board and only move mines around the frontier where the solver got stuck
+    LOCAL_REPAIR
+};
+
+/**
+ * @brief Whether the generator can ever produce a board for this configuration.
+ *
+ * Every board needs at least one safe cell to start from, and local repair needs room outside the start's 3x3 block
+ * for the mines it clears out of it. Anything else would have the generator retry forever.
+ */
+bool can_generate_board(int mine_count, int num_cells_x, int num_cells_y, bool no_guess,
+                        NGSGenerationMode generation_mode);
+
+/**
+ * @brief Makes a single generate + solve attempt, returning the board with its safe start marked if it passed.
+ *
+ * The overloads without an rng use a randomly seeded one per thread, pass one in for reproducible boards.
+ *
+ * @param stop the attempt gives up with std::nullopt as soon as it notices this is set.
+ */
+std::optional<FlatBoard> try_generate_ng_solvable_board(NGSSolver &solver, int mine_count, int num_cells_x,
+                                                        int num_cells_y, const std::atomic<bool> &stop = never_stop);
+std::optional<FlatBoard> try_generate_ng_solvable_board(NGSSolver &solver, int mine_count, int num_cells_x,
+                                                        int num_cells_y, std::mt19937 &rng,
+                                                        const std::atomic<bool> &stop = never_stop);
+
+/**
+ * @brief Makes a single local repair attempt on a fresh board.
+ *
+ * The area around a random start cell is cleared of mines and the board is played with an NGSSolver. Whenever the
+ * solver gets stuck a mine on the frontier is moved into the untouched interior (or the other way around when the
+ * frontier has no mines) and solving continues from the knowledge it already has, so only the area around the
+ * moved mine is reasoned about again. Once everything is revealed the board is solved again from scratch to make
+ * sure the final layout is no-guess solvable from the start cell.
+ *
+ * @param stop checked every repair round and inside the solver, the attempt gives up once it is set.
+ * @return std::nullopt if the repair budget runs out, there is nowhere left to move mines to or it was stopped.
+ */
+std::optional<FlatBoard> try_generate_ng_solvable_board_with_local_repair(NGSSolver &solver, int mine_count,
+                                                                          int num_cells_x, int num_cells_y,
+                                                                          const std::atomic<bool> &stop = never_stop);
+std::optional<FlatBoard> try_generate_ng_solvable_board_with_local_repair(NGSSolver &solver, int mine_count,
+                                                                          int num_cells_x, int num_cells_y,
+                                                                          std::mt19937 &rng,
+                                                                          const std::atomic<bool> &stop = never_stop);
+
+#endif // NGS_GENERATOR_HPP
@@ -0,0 +1,135 @@
+#include "frontier_components.hpp"
+
+#include <algorithm>
+
+std::string compute_component_signature(const FrontierComponent &component) {
+    std::vector<std::string> constraints;
+    constraints.reserve(component.constraint_variables.size());
+    for (std::size_t i = 0; i < component.constraint_variables.size(); i++) {
+        std::string constraint;
+        constraint.push_back(static_cast<char>(component.constraint_mines[i]));
+        constraint.push_back(static_cast<char>(component.constraint_variables[i].size()));
+        for (int variable : component.constraint_variables[i]) {
+            constraint.push_back(static_cast<char>(variable));
+        }
+        constraints.push_back(std::move(constraint));
+    }
+    // constraint order depends on where the numbers were on the board, sorting removes that
+    std::sort(constraints.begin(), constraints.end());
+    constraints.erase(std::unique(constraints.begin(), constraints.end()), constraints.end());
+
+    std::string signature;
+    signature.push_back(static_cast<char>(component.cells.size()));
+    for (const auto &constraint : constraints) {
+        signature += constraint;
+    }
+    return signature;
+}
+
+namespace {
+
+struct ComponentSearch {
+    const FrontierComponent &component;
+    long nodes_left;
+
+    std::vector<std::vector<int>> variable_constraints;
+    std::vector<int> assigned_mines;
+    std::vector<int> unassigned;
+    std::vector<std::int8_t> assignment;
+
+    std::vector<bool> seen_as_mine;
+    std::vector<bool> seen_as_safe;
+    int num_seen_both_ways = 0;
+
+    ComponentSearch(const FrontierComponent &component, long max_search_nodes)
+        : component(component), nodes_left(max_search_nodes), variable_constraints(component.cells.size()),
+          assigned_mines(component.constraint_variables.size(), 0), unassigned(component.constraint_variables.size()),
+          assignment(component.cells.size(), 0), seen_as_mine(component.cells.size(), false),
+          seen_as_safe(component.cells.size(), false) {
+        for (std::size_t c = 0; c < component.constraint_variables.size(); c++) {
+            unassigned[c] = component.constraint_variables[c].size();
+            for (int variable : component.constraint_variables[c]) {
+                variable_constraints[variable].push_back(c);
+            }
+        }
+    }
+
+    bool assign(int variable, std::int8_t value) {
+        assignment[variable] = value;
+        bool consistent = true;
+        for (int c : variable_constraints[variable]) {
+            assigned_mines[c] += value;
+            unassigned[c]--;
+            int target = component.constraint_mines[c];
+            consistent &= assigned_mines[c] <= target and assigned_mines[c] + unassigned[c] >= target;
+        }
+        return consistent;
+    }
+
+    void unassign(int variable) {
+        for (int c : variable_constraints[variable]) {
+            assigned_mines[c] -= assignment[variable];
+            unassigned[c]++;
+        }
+    }
+
+    void record_solution() {
+        for (std::size_t v = 0; v < assignment.size(); v++) {
+            bool was_seen_both_ways = seen_as_mine[v] and seen_as_safe[v];
+            (assignment[v] ? seen_as_mine : seen_as_safe)[v] = true;
+            if (not was_seen_both_ways and seen_as_mine[v] and seen_as_safe[v]) {
+                num_seen_both_ways++;
+            }
+        }
+    }
+
+    bool nothing_left_to_force() const { return num_seen_both_ways == static_cast<int>(assignment.size()); }
+
+    /**
+     * @return false once the search should stop, either out of budget or nothing can be forced anymore.
+     */
+    bool search(int variable) {
+        if (variable == static_cast<int>(assignment.size())) {
+            record_solution();
+            return not nothing_left_to_force();
+        }
+        if (--nodes_left < 0) {
+            return false;
+        }
+
+        for (std::int8_t value : {std::int8_t(0), std::int8_t(1)}) {
+            bool keep_going = true;
+            if (assign(variable, value)) {
+                keep_going = search(variable + 1);
+            }
+            unassign(variable);
+            if (not keep_going) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+ComponentResult enumerate_component(const FrontierComponent &component, long max_search_nodes) {
+    ComponentSearch search(component, max_search_nodes);
+    search.search(0);
+
+    ComponentResult result;
+    result.forced.assign(component.cells.size(), ComponentResult::UNDETERMINED);
+    result.complete = search.nodes_left >= 0;
+    if (not result.complete) {
+        return result;
+    }
+
+    for (std::size_t v = 0; v < component.cells.size(); v++) {
+        if (search.seen_as_mine[v] and not search.seen_as_safe[v]) {
+            result.forced[v] = ComponentResult::MINE;
+        } else if (search.seen_as_safe[v] and not search.seen_as_mine[v]) {
+            result.forced[v] = ComponentResult::SAFE;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef FRONTIER_COMPONENTS_HPP
+#define FRONTIER_COMPONENTS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A set of frontier cells together with every constraint that touches them, independent of all other cells.
+ *
+ * Cells are referred to by their index in the cells vector (a local variable index) inside the constraints, so two
+ * components with the same shape anywhere on any board end up with the same constraints and the same signature.
+ */
+struct FrontierComponent {
+    // global cell indices, in increasing order
+    std::vector<int> cells;
+    // local variable indices of each constraint, in increasing order
+    std::vector<std::vector<int>> constraint_variables;
+    // how many of each constraint's variables are mines
+    std::vector<int> constraint_mines;
+};
+
+/**
+ * @brief What every solution of a component agrees on.
+ */
+struct ComponentResult {
+    static constexpr std::int8_t UNDETERMINED = -1;
+    static constexpr std::int8_t SAFE = 0;
+    static constexpr std::int8_t MINE = 1;
+
+    // false if the search budget ran out, in which case nothing is forced
+    bool complete = false;
+    // per local variable, SAFE or MINE when every solution agrees, otherwise UNDETERMINED
+    std::vector<std::int8_t> forced;
+};
+
+/**
+ * @brief Canonical key of a component's constraint system, used to cache results.
+ */
+std::string compute_component_signature(const FrontierComponent &component);
+
+/**
+ * @brief Enumerates every mine assignment of the component that satisfies all of its constraints.
+ *
+ * The search stops early once every variable has been seen both as a mine and as safe since nothing can be forced
+ * after that, and gives up entirely after max_search_nodes assignments.
+ */
+ComponentResult enumerate_component(const FrontierComponent &component, long max_search_nodes);
+
+#endif // FRONTIER_COMPONENTS_HPP
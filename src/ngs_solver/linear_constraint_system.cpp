@@ -0,0 +1,182 @@
+#include "linear_constraint_system.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+// keeps products in eliminate well inside 64 bits
+constexpr std::int64_t max_coefficient = std::int64_t(1) << 30;
+
+int count_trailing_zeros(std::uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+} // namespace
+
+void LinearConstraintSystem::reset(int num_variables) {
+    this->num_variables = num_variables;
+    words_per_row = (num_variables + 63) / 64;
+    num_rows = 0;
+    coefficients.clear();
+    support.clear();
+    sums.clear();
+    upper_bounds.assign(num_variables, 1);
+}
+
+void LinearConstraintSystem::add_equation(const std::vector<int> &variables, int sum) {
+    coefficients.resize(coefficients.size() + num_variables, 0);
+    support.resize(support.size() + words_per_row, 0);
+    sums.push_back(sum);
+
+    std::int32_t *row = row_coefficients(num_rows);
+    std::uint64_t *mask = row_support(num_rows);
+    for (int variable : variables) {
+        row[variable] += 1;
+        mask[variable >> 6] |= std::uint64_t(1) << (variable & 63);
+    }
+    num_rows++;
+}
+
+void LinearConstraintSystem::swap_rows(int a, int b) {
+    if (a == b) {
+        return;
+    }
+    std::swap_ranges(row_coefficients(a), row_coefficients(a) + num_variables, row_coefficients(b));
+    std::swap_ranges(row_support(a), row_support(a) + words_per_row, row_support(b));
+    std::swap(sums[a], sums[b]);
+}
+
+bool LinearConstraintSystem::eliminate(int row, int pivot_row, int column) {
+    std::int32_t *target = row_coefficients(row);
+    std::int32_t *pivot = row_coefficients(pivot_row);
+    std::uint64_t *target_mask = row_support(row);
+    std::uint64_t *pivot_mask = row_support(pivot_row);
+
+    std::int64_t pivot_value = pivot[column];
+    std::int64_t row_value = target[column];
+
+    std::int64_t divisor = 0;
+    for (int w = 0; w < words_per_row; w++) {
+        std::uint64_t bits = target_mask[w] | pivot_mask[w];
+        std::uint64_t new_mask = 0;
+        while (bits != 0) {
+            int bit = count_trailing_zeros(bits);
+            bits &= bits - 1;
+            int c = w * 64 + bit;
+
+            std::int64_t value = target[c] * pivot_value - pivot[c] * row_value;
+            if (std::llabs(value) >= max_coefficient) {
+                return false;
+            }
+            target[c] = value;
+            if (value != 0) {
+                new_mask |= std::uint64_t(1) << bit;
+                divisor = std::gcd(divisor, value);
+            }
+        }
+        target_mask[w] = new_mask;
+    }
+
+    std::int64_t sum = sums[row] * pivot_value - sums[pivot_row] * row_value;
+    if (std::llabs(sum) >= max_coefficient) {
+        return false;
+    }
+    divisor = std::gcd(divisor, sum);
+    sums[row] = sum;
+
+    // dividing out the gcd keeps coefficients small, which is what lets fraction free elimination stay in range
+    if (divisor > 1) {
+        for (int w = 0; w < words_per_row; w++) {
+            std::uint64_t bits = target_mask[w];
+            while (bits != 0) {
+                int c = w * 64 + count_trailing_zeros(bits);
+                bits &= bits - 1;
+                target[c] /= divisor;
+            }
+        }
+        sums[row] /= divisor;
+    }
+    return true;
+}
+
+void LinearConstraintSystem::deduce_from_row(int row, std::vector<int> &forced) {
+    const std::int32_t *coefficient = row_coefficients(row);
+    const std::uint64_t *mask = row_support(row);
+
+    std::int64_t smallest = 0;
+    std::int64_t largest = 0;
+    bool empty = true;
+    for (int w = 0; w < words_per_row; w++) {
+        std::uint64_t bits = mask[w];
+        while (bits != 0) {
+            int c = w * 64 + count_trailing_zeros(bits);
+            bits &= bits - 1;
+            empty = false;
+            std::int64_t extreme = static_cast<std::int64_t>(coefficient[c]) * upper_bounds[c];
+            (extreme < 0 ? smallest : largest) += extreme;
+        }
+    }
+    if (empty or (sums[row] != smallest and sums[row] != largest)) {
+        return;
+    }
+
+    // at the maximum every positive term is at its upper bound and every negative term is zero, the minimum is the
+    // mirror image of that
+    bool at_largest = sums[row] == largest;
+    for (int w = 0; w < words_per_row; w++) {
+        std::uint64_t bits = mask[w];
+        while (bits != 0) {
+            int c = w * 64 + count_trailing_zeros(bits);
+            bits &= bits - 1;
+            bool positive = coefficient[c] > 0;
+            forced[c] = (positive == at_largest) ? upper_bounds[c] : 0;
+        }
+    }
+}
+
+bool LinearConstraintSystem::find_forced_values(std::vector<int> &forced) {
+    forced.assign(num_variables, UNDETERMINED);
+
+    int pivot_row = 0;
+    for (int column = 0; column < num_variables and pivot_row < num_rows; column++) {
+        std::uint64_t column_bit = std::uint64_t(1) << (column & 63);
+        int column_word = column >> 6;
+
+        int found = -1;
+        for (int row = pivot_row; row < num_rows; row++) {
+            if (row_support(row)[column_word] & column_bit) {
+                found = row;
+                break;
+            }
+        }
+        if (found == -1) {
+            continue;
+        }
+        swap_rows(found, pivot_row);
+
+        for (int row = 0; row < num_rows; row++) {
+            if (row != pivot_row and (row_support(row)[column_word] & column_bit)) {
+                if (not eliminate(row, pivot_row, column)) {
+                    forced.assign(num_variables, UNDETERMINED);
+                    return false;
+                }
+            }
+        }
+        pivot_row++;
+    }
+
+    for (int row = 0; row < num_rows; row++) {
+        deduce_from_row(row, forced);
+    }
+    return true;
+}
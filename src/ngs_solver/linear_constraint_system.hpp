@@ -0,0 +1,60 @@
+#ifndef LINEAR_CONSTRAINT_SYSTEM_HPP
+#define LINEAR_CONSTRAINT_SYSTEM_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Sparse 0/1 linear system over bounded integer variables, row reduced to find forced values.
+ *
+ * Each equation says that a set of variables sums to a value, every variable lies in [0, upper_bound] (1 for a
+ * single cell, more for a variable standing in for a group of cells). After fraction free Gauss-Jordan elimination
+ * a reduced row whose right hand side equals the largest or smallest value its left hand side can take forces every
+ * variable in it to one of its bounds.
+ *
+ * Mine counts are integer sums rather than parities, so elimination works over the integers instead of GF(2). Each
+ * row keeps a bit packed support mask next to its coefficients, pivot search is a bit test per row and row
+ * operations only visit words where either row has a nonzero entry.
+ */
+class LinearConstraintSystem {
+  public:
+    static constexpr int UNDETERMINED = -1;
+
+    /**
+     * @brief Clears all equations, variables start with an upper bound of 1.
+     */
+    void reset(int num_variables);
+
+    void set_upper_bound(int variable, int upper_bound) { upper_bounds[variable] = upper_bound; }
+
+    void add_equation(const std::vector<int> &variables, int sum);
+
+    /**
+     * @brief Row reduces the system and writes the forced value of every variable, or UNDETERMINED.
+     * @return false if coefficients grew too large to reduce safely, in which case nothing is forced.
+     */
+    bool find_forced_values(std::vector<int> &forced);
+
+  private:
+    std::int32_t *row_coefficients(int row) { return &coefficients[static_cast<std::size_t>(row) * num_variables]; }
+    std::uint64_t *row_support(int row) { return &support[static_cast<std::size_t>(row) * words_per_row]; }
+
+    void swap_rows(int a, int b);
+    /**
+     * @brief row = row * pivot_value - pivot_row * row_value, then divides out the gcd.
+     * @return false on overflow.
+     */
+    bool eliminate(int row, int pivot_row, int column);
+    void deduce_from_row(int row, std::vector<int> &forced);
+
+    int num_variables = 0;
+    int words_per_row = 0;
+    int num_rows = 0;
+
+    std::vector<std::int32_t> coefficients;
+    std::vector<std::uint64_t> support;
+    std::vector<std::int64_t> sums;
+    std::vector<int> upper_bounds;
+};
+
+#endif // LINEAR_CONSTRAINT_SYSTEM_HPP
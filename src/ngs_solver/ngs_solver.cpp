@@ -0,0 +1,524 @@
+#include "ngs_solver.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+void NGSSolver::reset(const FlatBoard &board, int mine_count) {
+    this->board = &board;
+    this->mine_count = mine_count;
+    num_cells_y = board.num_cells_y;
+    num_cells_x = board.num_cells_x;
+
+    num_safe_cells = num_cells_x * num_cells_y - mine_count;
+    num_revealed = 0;
+    num_known_mines = 0;
+
+    knowledge.assign(num_cells_x * num_cells_y, CellKnowledge::UNKNOWN);
+    in_worklist.assign(num_cells_x * num_cells_y, 0);
+    in_subset_worklist.assign(num_cells_x * num_cells_y, 0);
+    variable_of_cell.assign(num_cells_x * num_cells_y, -1);
+    frontier_variables.clear();
+    worklist.clear();
+    subset_worklist.clear();
+}
+
+std::optional<std::pair<int, int>> NGSSolver::solve(const FlatBoard &board, int mine_count,
+                                                    const std::atomic<bool> &stop) {
+    int num_cells = board.num_cells_x * board.num_cells_y;
+    covered_by_failed_attempt.assign(num_cells, false);
+
+    for (bool zeros_only : {true, false}) {
+        for (int idx = 0; idx < num_cells; idx++) {
+            int row = idx / board.num_cells_x;
+            int col = idx % board.num_cells_x;
+            if (covered_by_failed_attempt[idx] or board.is_mine(row, col) or
+                (zeros_only and board.get_adjacent_mines(row, col) != 0)) {
+                continue;
+            }
+
+            reset(board, mine_count);
+            reveal_start(row, col);
+            if (propagate(stop)) {
+                return std::make_pair(row, col);
+            }
+            if (stop.load(std::memory_order_relaxed)) {
+                return std::nullopt;
+            }
+            for (int i = 0; i < num_cells; i++) {
+                if (knowledge[i] == CellKnowledge::REVEALED) {
+                    covered_by_failed_attempt[i] = true;
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+bool NGSSolver::reveal_start(int row, int col) {
+    if (board->is_mine(row, col)) {
+        return false;
+    }
+    reveal(row, col);
+    return true;
+}
+
+void NGSSolver::push_dirty(int idx) {
+    if (not in_worklist[idx]) {
+        in_worklist[idx] = 1;
+        worklist.push_back(idx);
+    }
+}
+
+void NGSSolver::push_subset_candidate(int idx) {
+    if (not in_subset_worklist[idx]) {
+        in_subset_worklist[idx] = 1;
+        subset_worklist.push_back(idx);
+    }
+}
+
+void NGSSolver::mark_dirty_around(int row, int col) {
+    for (int r = row - 1; r <= row + 1; r++) {
+        for (int c = col - 1; c <= col + 1; c++) {
+            if (in_bounds(r, c) and knowledge[r * num_cells_x + c] == CellKnowledge::REVEALED) {
+                push_dirty(r * num_cells_x + c);
+            }
+        }
+    }
+}
+
+void NGSSolver::reveal(int row, int col) {
+    // flood fill through zeros, the same way the player sees the board open up
+    flood_stack.clear();
+    flood_stack.push_back(row * num_cells_x + col);
+    while (not flood_stack.empty()) {
+        int idx = flood_stack.back();
+        flood_stack.pop_back();
+        if (knowledge[idx] != CellKnowledge::UNKNOWN) {
+            continue;
+        }
+        knowledge[idx] = CellKnowledge::REVEALED;
+        num_revealed++;
+
+        int r = idx / num_cells_x;
+        int c = idx % num_cells_x;
+        // the new number plus every number that just lost an unknown neighbor
+        mark_dirty_around(r, c);
+
+        if (board->get_adjacent_mines(r, c) != 0) {
+            continue;
+        }
+        for (int dr = -1; dr <= 1; dr++) {
+            for (int dc = -1; dc <= 1; dc++) {
+                if (in_bounds(r + dr, c + dc) and
+                    knowledge[(r + dr) * num_cells_x + c + dc] == CellKnowledge::UNKNOWN) {
+                    flood_stack.push_back((r + dr) * num_cells_x + c + dc);
+                }
+            }
+        }
+    }
+}
+
+void NGSSolver::mark_mine(int row, int col) {
+    knowledge[row * num_cells_x + col] = CellKnowledge::MINE;
+    num_known_mines++;
+    mark_dirty_around(row, col);
+}
+
+bool NGSSolver::borders_revealed_cell(int row, int col) const {
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+            if (in_bounds(row + dr, col + dc) and
+                knowledge[(row + dr) * num_cells_x + col + dc] == CellKnowledge::REVEALED) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int NGSSolver::remaining_mines_around(int row, int col, std::vector<int> &unknown_neighbors) const {
+    unknown_neighbors.clear();
+    int known_mines = 0;
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+            if ((dr == 0 and dc == 0) or not in_bounds(row + dr, col + dc)) {
+                continue;
+            }
+            int idx = (row + dr) * num_cells_x + col + dc;
+            if (knowledge[idx] == CellKnowledge::UNKNOWN) {
+                unknown_neighbors.push_back(idx);
+            } else if (knowledge[idx] == CellKnowledge::MINE) {
+                known_mines++;
+            }
+        }
+    }
+    return board->get_adjacent_mines(row, col) - known_mines;
+}
+
+bool NGSSolver::apply_single_cell_rule(int row, int col) {
+    int remaining = remaining_mines_around(row, col, unknown_a);
+    if (unknown_a.empty()) {
+        return false;
+    }
+
+    if (remaining == 0) {
+        for (int idx : unknown_a) {
+            reveal(idx / num_cells_x, idx % num_cells_x);
+        }
+        return true;
+    }
+    if (remaining == static_cast<int>(unknown_a.size())) {
+        for (int idx : unknown_a) {
+            mark_mine(idx / num_cells_x, idx % num_cells_x);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool NGSSolver::apply_subset_difference(const std::vector<int> &superset, const std::vector<int> &subset,
+                                        int difference_mines) {
+    // both lists are built in the same scan order so they are sorted
+    if (not std::includes(superset.begin(), superset.end(), subset.begin(), subset.end())) {
+        return false;
+    }
+
+    difference.clear();
+    std::set_difference(superset.begin(), superset.end(), subset.begin(), subset.end(),
+                        std::back_inserter(difference));
+    if (difference_mines == 0) {
+        for (int idx : difference) {
+            reveal(idx / num_cells_x, idx % num_cells_x);
+        }
+        return true;
+    }
+    if (difference_mines == static_cast<int>(difference.size())) {
+        for (int idx : difference) {
+            mark_mine(idx / num_cells_x, idx % num_cells_x);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool NGSSolver::apply_subset_rule(int row, int col) {
+    int remaining_a = remaining_mines_around(row, col, unknown_a);
+    if (unknown_a.empty()) {
+        return false;
+    }
+
+    // any number sharing an unknown neighbor with this one is at most two cells away, the pair is checked both ways
+    // since this cell is the one whose unknown neighbors changed
+    for (int r = row - 2; r <= row + 2; r++) {
+        for (int c = col - 2; c <= col + 2; c++) {
+            if ((r == row and c == col) or not in_bounds(r, c) or
+                knowledge[r * num_cells_x + c] != CellKnowledge::REVEALED) {
+                continue;
+            }
+
+            int remaining_b = remaining_mines_around(r, c, unknown_b);
+            if (unknown_b.size() > unknown_a.size()) {
+                if (apply_subset_difference(unknown_b, unknown_a, remaining_b - remaining_a)) {
+                    return true;
+                }
+            } else if (unknown_b.size() < unknown_a.size() and not unknown_b.empty()) {
+                if (apply_subset_difference(unknown_a, unknown_b, remaining_a - remaining_b)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool NGSSolver::apply_global_rule() {
+    int remaining_mines = mine_count - num_known_mines;
+    int num_unknown = num_cells_x * num_cells_y - num_revealed - num_known_mines;
+    if (num_unknown == 0 or (remaining_mines != 0 and remaining_mines != num_unknown)) {
+        return false;
+    }
+
+    for (int idx = 0; idx < num_cells_x * num_cells_y; idx++) {
+        if (knowledge[idx] != CellKnowledge::UNKNOWN) {
+            continue;
+        }
+        if (remaining_mines == 0) {
+            reveal(idx / num_cells_x, idx % num_cells_x);
+        } else {
+            mark_mine(idx / num_cells_x, idx % num_cells_x);
+        }
+    }
+    return true;
+}
+
+bool NGSSolver::propagate(const std::atomic<bool> &stop) {
+    while (not is_solved()) {
+        // a relaxed load per step is cheap next to any rule, and lets a cancelled attempt stop mid board
+        if (stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (not worklist.empty()) {
+            int idx = worklist.back();
+            worklist.pop_back();
+            in_worklist[idx] = 0;
+
+            if (not apply_single_cell_rule(idx / num_cells_x, idx % num_cells_x) and not unknown_a.empty()) {
+                push_subset_candidate(idx);
+            }
+            continue;
+        }
+
+        // the subset rule is much more expensive, only reach for it once single cells are exhausted
+        if (not subset_worklist.empty()) {
+            int idx = subset_worklist.back();
+            subset_worklist.pop_back();
+            in_subset_worklist[idx] = 0;
+
+            apply_subset_rule(idx / num_cells_x, idx % num_cells_x);
+            continue;
+        }
+
+        if (not apply_global_rule() and not apply_linear_algebra_rule() and not apply_component_rule()) {
+            break;
+        }
+    }
+    return is_solved();
+}
+
+void NGSSolver::collect_frontier_constraints() {
+    for (int idx : frontier_variables) {
+        variable_of_cell[idx] = -1;
+    }
+    frontier_variables.clear();
+    constraint_cells.clear();
+
+    for (int idx = 0; idx < num_cells_x * num_cells_y; idx++) {
+        if (knowledge[idx] != CellKnowledge::REVEALED) {
+            continue;
+        }
+        remaining_mines_around(idx / num_cells_x, idx % num_cells_x, unknown_a);
+        if (unknown_a.empty()) {
+            continue;
+        }
+        constraint_cells.push_back(idx);
+        for (int cell : unknown_a) {
+            if (variable_of_cell[cell] == -1) {
+                variable_of_cell[cell] = frontier_variables.size();
+                frontier_variables.push_back(cell);
+            }
+        }
+    }
+}
+
+bool NGSSolver::apply_linear_algebra_rule() {
+    collect_frontier_constraints();
+    int num_frontier = frontier_variables.size();
+    if (num_frontier == 0 or num_frontier > max_linear_variables) {
+        return false;
+    }
+
+    int num_unknown = num_cells_x * num_cells_y - num_revealed - num_known_mines;
+    int num_interior = num_unknown - num_frontier;
+    int interior_variable = num_interior > 0 ? num_frontier : -1;
+
+    linear_system.reset(num_frontier + (num_interior > 0 ? 1 : 0));
+    if (num_interior > 0) {
+        linear_system.set_upper_bound(interior_variable, num_interior);
+    }
+
+    for (int idx : constraint_cells) {
+        int remaining = remaining_mines_around(idx / num_cells_x, idx % num_cells_x, unknown_a);
+        variables.clear();
+        for (int cell : unknown_a) {
+            variables.push_back(variable_of_cell[cell]);
+        }
+        linear_system.add_equation(variables, remaining);
+    }
+
+    // the global equation, every unknown cell on or off the frontier adds up to the mines not yet found
+    variables.clear();
+    for (int v = 0; v < num_frontier + (num_interior > 0 ? 1 : 0); v++) {
+        variables.push_back(v);
+    }
+    linear_system.add_equation(variables, mine_count - num_known_mines);
+
+    if (not linear_system.find_forced_values(forced_values)) {
+        return false;
+    }
+
+    bool progress = false;
+    for (int v = 0; v < num_frontier; v++) {
+        int cell = frontier_variables[v];
+        if (forced_values[v] == LinearConstraintSystem::UNDETERMINED or knowledge[cell] != CellKnowledge::UNKNOWN) {
+            continue;
+        }
+        if (forced_values[v] == 0) {
+            reveal(cell / num_cells_x, cell % num_cells_x);
+        } else {
+            mark_mine(cell / num_cells_x, cell % num_cells_x);
+        }
+        progress = true;
+    }
+
+    if (interior_variable != -1 and forced_values[interior_variable] != LinearConstraintSystem::UNDETERMINED) {
+        bool interior_is_safe = forced_values[interior_variable] == 0;
+        for (int cell = 0; cell < num_cells_x * num_cells_y; cell++) {
+            if (knowledge[cell] != CellKnowledge::UNKNOWN or variable_of_cell[cell] != -1) {
+                continue;
+            }
+            if (interior_is_safe) {
+                reveal(cell / num_cells_x, cell % num_cells_x);
+            } else {
+                mark_mine(cell / num_cells_x, cell % num_cells_x);
+            }
+            progress = true;
+        }
+    }
+    return progress;
+}
+
+void NGSSolver::build_frontier_components() {
+    collect_frontier_constraints();
+    component_parent.resize(frontier_variables.size());
+    for (std::size_t v = 0; v < frontier_variables.size(); v++) {
+        component_parent[v] = v;
+    }
+
+    auto find_root = [&](int v) {
+        while (component_parent[v] != v) {
+            component_parent[v] = component_parent[component_parent[v]];
+            v = component_parent[v];
+        }
+        return v;
+    };
+
+    // all unknown neighbors of a constraint share a component
+    for (int idx : constraint_cells) {
+        remaining_mines_around(idx / num_cells_x, idx % num_cells_x, unknown_a);
+        int first_root = find_root(variable_of_cell[unknown_a[0]]);
+        for (int cell : unknown_a) {
+            int root = find_root(variable_of_cell[cell]);
+            if (root != first_root) {
+                component_parent[root] = first_root;
+            }
+        }
+    }
+
+    components.clear();
+    std::unordered_map<int, int> component_of_root;
+    std::vector<int> local_index(frontier_variables.size());
+    // frontier_variables is not sorted, walk cells in board order so local indices follow row major order
+    std::vector<int> sorted_variables(frontier_variables.size());
+    for (std::size_t v = 0; v < frontier_variables.size(); v++) {
+        sorted_variables[v] = v;
+    }
+    std::sort(sorted_variables.begin(), sorted_variables.end(),
+              [&](int a, int b) { return frontier_variables[a] < frontier_variables[b]; });
+    for (int v : sorted_variables) {
+        int root = find_root(v);
+        auto [it, inserted] = component_of_root.emplace(root, components.size());
+        if (inserted) {
+            components.emplace_back();
+        }
+        local_index[v] = components[it->second].cells.size();
+        components[it->second].cells.push_back(frontier_variables[v]);
+    }
+
+    for (int idx : constraint_cells) {
+        int remaining = remaining_mines_around(idx / num_cells_x, idx % num_cells_x, unknown_a);
+        FrontierComponent &component = components[component_of_root.at(find_root(variable_of_cell[unknown_a[0]]))];
+
+        std::vector<int> local_variables;
+        local_variables.reserve(unknown_a.size());
+        for (int cell : unknown_a) {
+            local_variables.push_back(local_index[variable_of_cell[cell]]);
+        }
+        std::sort(local_variables.begin(), local_variables.end());
+        component.constraint_variables.push_back(std::move(local_variables));
+        component.constraint_mines.push_back(remaining);
+    }
+}
+
+bool NGSSolver::apply_component_rule() {
+    build_frontier_components();
+
+    std::vector<std::string> signatures(components.size());
+    std::vector<ComponentResult> results(components.size());
+    std::vector<std::pair<std::size_t, std::future<ComponentResult>>> pending;
+
+    for (std::size_t i = 0; i < components.size(); i++) {
+        const FrontierComponent &component = components[i];
+        if (static_cast<int>(component.cells.size()) > max_component_variables) {
+            continue;
+        }
+
+        signatures[i] = compute_component_signature(component);
+        auto cached = component_cache.find(signatures[i]);
+        if (cached != component_cache.end()) {
+            results[i] = cached->second;
+            continue;
+        }
+
+        if (thread_pool != nullptr and static_cast<int>(component.cells.size()) >= parallel_component_variables) {
+            pending.emplace_back(i, thread_pool->submit([&component]() {
+                return enumerate_component(component, max_search_nodes);
+            }));
+        } else {
+            results[i] = enumerate_component(component, max_search_nodes);
+            component_cache.emplace(signatures[i], results[i]);
+        }
+    }
+
+    for (auto &[i, future] : pending) {
+        results[i] = thread_pool->wait_for(future);
+        component_cache.emplace(signatures[i], results[i]);
+    }
+    if (component_cache.size() > max_cached_components) {
+        component_cache.clear();
+    }
+
+    bool progress = false;
+    for (std::size_t i = 0; i < components.size(); i++) {
+        if (not results[i].complete) {
+            continue;
+        }
+        for (std::size_t v = 0; v < components[i].cells.size(); v++) {
+            int cell = components[i].cells[v];
+            if (knowledge[cell] != CellKnowledge::UNKNOWN) {
+                continue;
+            }
+            if (results[i].forced[v] == ComponentResult::SAFE) {
+                reveal(cell / num_cells_x, cell % num_cells_x);
+                progress = true;
+            } else if (results[i].forced[v] == ComponentResult::MINE) {
+                mark_mine(cell / num_cells_x, cell % num_cells_x);
+                progress = true;
+            }
+        }
+    }
+    return progress;
+}
+
+std::vector<std::pair<int, int>> NGSSolver::get_frontier() const {
+    std::vector<std::pair<int, int>> frontier;
+    for (int row = 0; row < num_cells_y; row++) {
+        for (int col = 0; col < num_cells_x; col++) {
+            if (knowledge[row * num_cells_x + col] == CellKnowledge::UNKNOWN and borders_revealed_cell(row, col)) {
+                frontier.emplace_back(row, col);
+            }
+        }
+    }
+    return frontier;
+}
+
+std::vector<std::pair<int, int>> NGSSolver::get_interior() const {
+    std::vector<std::pair<int, int>> interior;
+    for (int row = 0; row < num_cells_y; row++) {
+        for (int col = 0; col < num_cells_x; col++) {
+            if (knowledge[row * num_cells_x + col] == CellKnowledge::UNKNOWN and not borders_revealed_cell(row, col)) {
+                interior.emplace_back(row, col);
+            }
+        }
+    }
+    return interior;
+}
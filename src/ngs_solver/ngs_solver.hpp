@@ -0,0 +1,180 @@
+#ifndef NGS_SOLVER_HPP
+#define NGS_SOLVER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../flat_board/flat_board.hpp"
+#include "../thread_pool/thread_pool.hpp"
+#include "frontier_components.hpp"
+#include "linear_constraint_system.hpp"
+
+/**
+ * @brief A stop flag that is never set, the default for callers that don't cancel solving or generation.
+ */
+inline const std::atomic<bool> never_stop{false};
+
+/**
+ * @brief Plays a board from a starting cell using only sound deductions, and remembers how far it got.
+ *
+ * Unlike Solver::solve which only answers yes or no, this keeps the knowledge state around after it gets stuck so
+ * that a generator can change mines near the frontier and continue from where it left off instead of rerolling.
+ *
+ * Deductions used:
+ * - single cell: a revealed number whose remaining mines equal zero or equal its unknown neighbor count
+ * - subset: when one number's unknown neighbors are a subset of another's, the difference is forced
+ * - global: the remaining mine count is zero or equals the number of unknown cells
+ * - linear algebra: every frontier constraint plus the total mine count written as a linear system and row reduced,
+ *   a reduced row at the edge of its possible range forces all of its cells. Cells away from the frontier share a
+ *   single variable so the mine count can take part without blowing up the system.
+ * - components: once the rules above run dry the frontier is split into independent components and every
+ *   assignment of each component is enumerated, cells that agree across all of them are forced. Large components are
+ *   handed to the thread pool if there is one and results are cached by constraint signature, so the cost depends on
+ *   the largest component rather than the whole frontier.
+ *
+ * Propagation is incremental, revealing a cell or finding a mine only puts the revealed numbers around it on a
+ * worklist, so each step only reconsiders the neighborhood that actually changed. All buffers keep their capacity
+ * across reset calls so one instance can be reused for every generation attempt on a thread.
+ *
+ * @note the board is read through a pointer so the caller has to keep it alive. Mines may be moved between propagate
+ * calls as long as no revealed or deduced cell changes, and mark_dirty_around has to be called for every moved mine.
+ */
+class NGSSolver {
+  public:
+    enum class CellKnowledge : std::uint8_t { UNKNOWN, REVEALED, MINE };
+
+    explicit NGSSolver(WorkStealingThreadPool *thread_pool = nullptr) : thread_pool(thread_pool) {}
+
+    void reset(const FlatBoard &board, int mine_count);
+
+    /**
+     * @brief Looks for a start cell from which the whole board can be solved without guessing.
+     *
+     * Zero cells are tried first since they open up an area, every cell revealed by a failed attempt is skipped
+     * afterwards because starting from it cannot get further than the attempt that revealed it.
+     *
+     * @param stop checked between deduction steps, once it is set this gives up and returns std::nullopt.
+     * @return the (row, col) of the start cell, or std::nullopt if the board needs a guess from everywhere.
+     */
+    std::optional<std::pair<int, int>> solve(const FlatBoard &board, int mine_count,
+                                             const std::atomic<bool> &stop = never_stop);
+
+    /**
+     * @brief Reveals the starting cell, opening up zeros like the game does.
+     * @return false if the starting cell is a mine.
+     */
+    bool reveal_start(int row, int col);
+
+    /**
+     * @brief Applies deductions until none are left.
+     * @param stop checked between deduction steps, once it is set this returns early.
+     * @return true if every safe cell has been revealed.
+     */
+    bool propagate(const std::atomic<bool> &stop = never_stop);
+
+    /**
+     * @brief Queues the revealed numbers around a cell for another look, e.g. after a mine was moved there.
+     */
+    void mark_dirty_around(int row, int col);
+
+    bool is_solved() const { return num_revealed == num_safe_cells; }
+
+    /**
+     * @brief Unknown cells bordering at least one revealed cell, this is where the solver got stuck.
+     */
+    std::vector<std::pair<int, int>> get_frontier() const;
+
+    /**
+     * @brief Unknown cells that do not border any revealed cell.
+     */
+    std::vector<std::pair<int, int>> get_interior() const;
+
+    CellKnowledge get_knowledge(int row, int col) const { return knowledge[row * num_cells_x + col]; }
+
+  private:
+    bool in_bounds(int row, int col) const {
+        return row >= 0 and row < num_cells_y and col >= 0 and col < num_cells_x;
+    }
+
+    void reveal(int row, int col);
+    void mark_mine(int row, int col);
+    bool borders_revealed_cell(int row, int col) const;
+
+    void push_dirty(int idx);
+    void push_subset_candidate(int idx);
+
+    /**
+     * @brief Collects the unknown neighbors of a revealed cell and returns how many of them are mines.
+     */
+    int remaining_mines_around(int row, int col, std::vector<int> &unknown_neighbors) const;
+
+    bool apply_single_cell_rule(int row, int col);
+    bool apply_subset_rule(int row, int col);
+    bool apply_subset_difference(const std::vector<int> &superset, const std::vector<int> &subset,
+                                 int difference_mines);
+    bool apply_global_rule();
+    bool apply_linear_algebra_rule();
+    bool apply_component_rule();
+
+    /**
+     * @brief Finds the revealed numbers that still have unknown neighbors and numbers those neighbors as variables.
+     */
+    void collect_frontier_constraints();
+
+    /**
+     * @brief Splits the unknown cells bordering revealed numbers into components that share no constraint.
+     */
+    void build_frontier_components();
+
+    // components bigger than this are not enumerated at all, the search space is too large to be worth it
+    static constexpr int max_component_variables = 64;
+    // the linear system is dense per row, past this many variables it costs more than it saves
+    static constexpr int max_linear_variables = 1024;
+    // components at least this big are worth the overhead of sending them to the thread pool
+    static constexpr int parallel_component_variables = 16;
+    static constexpr long max_search_nodes = 1 << 20;
+    static constexpr std::size_t max_cached_components = 1 << 14;
+
+    WorkStealingThreadPool *thread_pool;
+    std::unordered_map<std::string, ComponentResult> component_cache;
+    LinearConstraintSystem linear_system;
+
+    const FlatBoard *board = nullptr;
+    int num_cells_x = 0;
+    int num_cells_y = 0;
+    int mine_count = 0;
+
+    int num_safe_cells = 0;
+    int num_revealed = 0;
+    int num_known_mines = 0;
+
+    std::vector<CellKnowledge> knowledge;
+
+    // revealed numbers whose unknown neighbors changed since the single cell rule last looked at them
+    std::vector<int> worklist;
+    std::vector<std::uint8_t> in_worklist;
+    // revealed numbers that the single cell rule could not resolve, waiting for the subset rule
+    std::vector<int> subset_worklist;
+    std::vector<std::uint8_t> in_subset_worklist;
+
+    // scratch space reused between rule applications so that propagating does not allocate
+    std::vector<int> flood_stack;
+    std::vector<int> unknown_a;
+    std::vector<int> unknown_b;
+    std::vector<int> difference;
+    std::vector<int> variable_of_cell;
+    std::vector<int> frontier_variables;
+    std::vector<int> constraint_cells;
+    std::vector<int> variables;
+    std::vector<int> forced_values;
+    std::vector<int> component_parent;
+    std::vector<FrontierComponent> components;
+    std::vector<bool> covered_by_failed_attempt;
+};
+
+#endif // NGS_SOLVER_HPP
@@ -0,0 +1,168 @@
+#include "pooled_sound_system.hpp"
+
+#include <future>
+#include <iostream>
+#include <sndfile.h>
+#include <stdexcept>
+
+namespace {
+
+struct DecodedSound {
+    std::vector<short> samples;
+    int channels;
+    int sample_rate;
+};
+
+DecodedSound decode_sound_file(const std::string &path) {
+    SF_INFO info{};
+    SNDFILE *file = sf_open(path.c_str(), SFM_READ, &info);
+    if (file == nullptr) {
+        throw std::runtime_error("couldn't open sound file " + path + ": " + sf_strerror(nullptr));
+    }
+    if (info.channels != 1 and info.channels != 2) {
+        sf_close(file);
+        throw std::runtime_error("sound file " + path + " has " + std::to_string(info.channels) +
+                                 " channels, only mono and stereo are supported");
+    }
+
+    DecodedSound decoded;
+    decoded.channels = info.channels;
+    decoded.sample_rate = info.samplerate;
+    decoded.samples.resize(static_cast<std::size_t>(info.frames) * info.channels);
+    sf_count_t frames_read = sf_readf_short(file, decoded.samples.data(), info.frames);
+    decoded.samples.resize(static_cast<std::size_t>(frames_read) * info.channels);
+    sf_close(file);
+    return decoded;
+}
+
+} // namespace
+
+PooledSoundSystem::PooledSoundSystem(std::size_t num_voices,
+                                     const std::unordered_map<SoundType, std::string> &sound_type_to_file) {
+    // decoding is the slow part, so every file gets its own thread
+    std::vector<std::pair<SoundType, std::future<DecodedSound>>> decodes;
+    for (const auto &[type, path] : sound_type_to_file) {
+        decodes.emplace_back(type, std::async(std::launch::async, decode_sound_file, path));
+    }
+    // waited on before the device is opened, so a bad file can't leave it open
+    std::vector<std::pair<SoundType, DecodedSound>> decoded_sounds;
+    for (auto &[type, decode] : decodes) {
+        decoded_sounds.emplace_back(type, decode.get());
+    }
+
+    device = alcOpenDevice(nullptr);
+    if (device == nullptr) {
+        throw std::runtime_error("couldn't open the default audio device");
+    }
+    context = alcCreateContext(device, nullptr);
+    if (context == nullptr or not alcMakeContextCurrent(context)) {
+        alcCloseDevice(device);
+        throw std::runtime_error("couldn't create an audio context");
+    }
+
+    // OpenAL copies the samples into the buffer, the decoded copy only lives until then
+    for (const auto &[type, decoded] : decoded_sounds) {
+        ALuint buffer;
+        alGenBuffers(1, &buffer);
+        alBufferData(buffer, decoded.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16, decoded.samples.data(),
+                     static_cast<ALsizei>(decoded.samples.size() * sizeof(short)), decoded.sample_rate);
+        sound_buffers[type] = buffer;
+    }
+
+    voices.resize(num_voices);
+    for (auto &voice : voices) {
+        alGenSources(1, &voice.source);
+    }
+
+    if (alGetError() != AL_NO_ERROR) {
+        std::cout << "openal reported an error while setting up the sound system" << std::endl;
+    }
+
+    audio_thread = std::thread(&PooledSoundSystem::run_audio_thread, this);
+}
+
+PooledSoundSystem::~PooledSoundSystem() {
+    stop_requested = true;
+    wake_audio_thread();
+    audio_thread.join();
+
+    for (auto &voice : voices) {
+        alSourceStop(voice.source);
+        alDeleteSources(1, &voice.source);
+    }
+    for (auto &[type, buffer] : sound_buffers) {
+        alDeleteBuffers(1, &buffer);
+    }
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+}
+
+PooledSoundSystem::Voice &PooledSoundSystem::acquire_voice() {
+    Voice *oldest = &voices.front();
+    for (auto &voice : voices) {
+        ALint state;
+        alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+        if (state != AL_PLAYING) {
+            return voice;
+        }
+        if (voice.started_at < oldest->started_at) {
+            oldest = &voice;
+        }
+    }
+    alSourceStop(oldest->source);
+    return *oldest;
+}
+
+void PooledSoundSystem::play_sound(SoundType type, const glm::vec3 &position) {
+    auto buffer = sound_buffers.find(type);
+    if (voices.empty() or buffer == sound_buffers.end()) {
+        return;
+    }
+
+    Voice &voice = acquire_voice();
+    // a buffer can only be swapped on a source that isn't playing, acquire_voice made sure of that
+    alSourcei(voice.source, AL_BUFFER, static_cast<ALint>(buffer->second));
+    alSource3f(voice.source, AL_POSITION, position.x, position.y, position.z);
+    alSourcePlay(voice.source);
+    voice.started_at = ++sounds_started;
+}
+
+void PooledSoundSystem::queue_sound(SoundType type, const glm::vec3 &position) {
+    if (not queued_sounds.try_push({type, position})) {
+        return;
+    }
+    // pairs with the fence in run_audio_thread, either the audio thread sees the sound when it checks the queue
+    // before waiting or this sees it as asleep, so the lock is only taken when there is someone to wake
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (audio_thread_sleeping.load(std::memory_order_relaxed)) {
+        wake_audio_thread();
+    }
+}
+
+void PooledSoundSystem::wake_audio_thread() {
+    // taking the lock, even for nothing, means the audio thread can't be between checking the queue and starting to
+    // wait, so the notify can't land in that gap and be lost
+    { std::lock_guard<std::mutex> lock(wake_mutex); }
+    wake_condition.notify_one();
+}
+
+void PooledSoundSystem::run_audio_thread() {
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    while (true) {
+        audio_thread_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // the predicate checks the queue again before blocking, which catches a sound pushed before the flag was seen
+        wake_condition.wait(lock, [&] { return stop_requested or not queued_sounds.empty(); });
+        audio_thread_sleeping.store(false, std::memory_order_relaxed);
+        if (stop_requested) {
+            return;
+        }
+        // the producer only takes the lock to wake this thread, don't hold it while playing
+        lock.unlock();
+        while (auto queued = queued_sounds.try_pop()) {
+            play_sound(queued->type, queued->position);
+        }
+        lock.lock();
+    }
+}
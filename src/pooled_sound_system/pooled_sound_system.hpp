@@ -0,0 +1,86 @@
+#ifndef POOLED_SOUND_SYSTEM_HPP
+#define POOLED_SOUND_SYSTEM_HPP
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../sound_types/sound_types.hpp"
+#include "../spsc_ring_buffer/spsc_ring_buffer.hpp"
+
+/**
+ * @brief Plays the game's sound effects from buffers decoded once at startup, on a fixed pool of voices.
+ *
+ * Every sound file is decoded in parallel when the system is created and handed to its own OpenAL buffer, so
+ * playing a sound never decodes or allocates, it only points a voice at a buffer. The voices (OpenAL sources) are
+ * all created up front. A finished voice is reused, and when every voice is busy the one that started longest ago
+ * is cut off, which is the one the player is least likely to notice.
+ *
+ * After construction every OpenAL call happens on the system's own audio thread. queue_sound only pushes onto a
+ * lock free queue, so a click is heard about as soon as it is handled no matter how long the frame takes, and the
+ * frame never waits on OpenAL. With nothing queued the audio thread is blocked rather than polling, queue_sound only
+ * takes a lock to wake it when it has said it is about to block.
+ *
+ * @note queue_sound must only be called from one thread, the queue has a single producer.
+ */
+class PooledSoundSystem {
+  public:
+    /**
+     * @param num_voices how many sounds can play at once.
+     * @throws std::runtime_error if there is no audio device or a sound file can't be decoded.
+     */
+    PooledSoundSystem(std::size_t num_voices, const std::unordered_map<SoundType, std::string> &sound_type_to_file);
+    ~PooledSoundSystem();
+
+    PooledSoundSystem(const PooledSoundSystem &) = delete;
+    PooledSoundSystem &operator=(const PooledSoundSystem &) = delete;
+
+    /**
+     * @brief Hands the sound to the audio thread, if more sounds are queued than it has caught up with it's dropped.
+     */
+    void queue_sound(SoundType type, const glm::vec3 &position);
+
+  private:
+    struct QueuedSound {
+        SoundType type;
+        glm::vec3 position;
+    };
+
+    struct Voice {
+        ALuint source;
+        // larger is more recent, for picking which voice to steal
+        std::uint64_t started_at = 0;
+    };
+
+    Voice &acquire_voice();
+    void run_audio_thread();
+    void wake_audio_thread();
+    void play_sound(SoundType type, const glm::vec3 &position);
+
+    ALCdevice *device;
+    ALCcontext *context;
+
+    std::unordered_map<SoundType, ALuint> sound_buffers;
+    std::vector<Voice> voices;
+    std::uint64_t sounds_started = 0;
+
+    SpscRingBuffer<QueuedSound, 64> queued_sounds;
+    std::atomic<bool> stop_requested{false};
+    // set by the audio thread just before it blocks, queue_sound only needs to wake it while this is set
+    std::atomic<bool> audio_thread_sleeping{false};
+    // the audio thread waits on this while the queue is empty, only the wait and wake use the mutex
+    std::mutex wake_mutex;
+    std::condition_variable wake_condition;
+    // started last in the constructor, once everything it uses exists
+    std::thread audio_thread;
+};
+
+#endif // POOLED_SOUND_SYSTEM_HPP
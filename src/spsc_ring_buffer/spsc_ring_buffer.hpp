@@ -0,0 +1,61 @@
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+/**
+ * @brief A fixed size queue between exactly one producer thread and one consumer thread, without locks.
+ *
+ * The producer only ever writes tail and the consumer only ever writes head, each reads the other's index with
+ * acquire ordering so the slot contents written before the release store are visible. Neither side blocks, a push
+ * to a full buffer and a pop from an empty one just fail.
+ *
+ * @note Capacity has to be a power of two, the indices run freely and are masked into the array.
+ */
+template <typename T, std::size_t Capacity> class SpscRingBuffer {
+    static_assert(Capacity > 0 and (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+  public:
+    /**
+     * @return false if the buffer was full, the value is dropped.
+     * @note producer thread only.
+     */
+    bool try_push(const T &value) {
+        std::size_t tail_index = tail.load(std::memory_order_relaxed);
+        if (tail_index - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[tail_index & (Capacity - 1)] = value;
+        tail.store(tail_index + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @note consumer thread only.
+     */
+    std::optional<T> try_pop() {
+        std::size_t head_index = head.load(std::memory_order_relaxed);
+        if (head_index == tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        T value = slots[head_index & (Capacity - 1)];
+        head.store(head_index + 1, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @note consumer thread only, from the producer it can be stale by the time it returns.
+     */
+    bool empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire); }
+
+  private:
+    std::array<T, Capacity> slots;
+    // on separate cache lines so the two threads don't keep stealing the line from each other
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+};
+
+#endif // SPSC_RING_BUFFER_HPP
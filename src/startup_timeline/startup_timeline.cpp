@@ -0,0 +1,37 @@
+#include "startup_timeline.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+void StartupTimeline::record(const std::string &name, clock::time_point step_start, clock::time_point step_end) {
+    std::lock_guard<std::mutex> lock(steps_mutex);
+    steps.push_back({name, std::this_thread::get_id(), step_start, step_end});
+}
+
+void StartupTimeline::print_report() const {
+    std::vector<Step> sorted_steps;
+    {
+        std::lock_guard<std::mutex> lock(steps_mutex);
+        sorted_steps = steps;
+    }
+    std::stable_sort(sorted_steps.begin(), sorted_steps.end(),
+                     [](const Step &a, const Step &b) { return a.start < b.start; });
+
+    // thread ids aren't readable, number them in order of appearance with the main thread first
+    std::vector<std::thread::id> threads = {std::this_thread::get_id()};
+    auto to_ms = [](clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+    std::cout << "startup timeline, ms since start" << std::endl;
+    std::cout << std::setw(10) << "start" << std::setw(10) << "took" << std::setw(8) << "thread"
+              << "  step" << std::endl;
+    for (const auto &step : sorted_steps) {
+        auto thread = std::find(threads.begin(), threads.end(), step.thread);
+        if (thread == threads.end()) {
+            thread = threads.insert(threads.end(), step.thread);
+        }
+        std::cout << std::fixed << std::setprecision(1) << std::setw(10) << to_ms(step.start - start)
+                  << std::setw(10) << to_ms(step.end - step.start) << std::setw(8) << (thread - threads.begin())
+                  << "  " << step.name << std::endl;
+    }
+}
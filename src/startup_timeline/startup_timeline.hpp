@@ -0,0 +1,68 @@
+#ifndef STARTUP_TIMELINE_HPP
+#define STARTUP_TIMELINE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Records how long each startup step took and on which thread, so time to first frame can be tracked and
+ * the step holding it up found.
+ *
+ * Steps can be timed from any thread. Times are relative to when the timeline was created, which should be as
+ * early in main as possible.
+ */
+class StartupTimeline {
+  public:
+    StartupTimeline() : start(clock::now()) {}
+
+    /**
+     * @brief Runs the step and records how long it took.
+     * @return whatever the step returns, constructed in place so it doesn't need to be movable
+     */
+    template <typename Step> decltype(auto) time(const std::string &name, Step &&step) {
+        StepRecorder recorder{*this, name, clock::now()};
+        return step();
+    }
+
+    /**
+     * @brief Records a point in time rather than a step, such as the first frame being shown.
+     */
+    void mark(const std::string &name) {
+        clock::time_point now = clock::now();
+        record(name, now, now);
+    }
+
+    /**
+     * @brief Prints every step in the order they started.
+     */
+    void print_report() const;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct Step {
+        std::string name;
+        std::thread::id thread;
+        clock::time_point start;
+        clock::time_point end;
+    };
+
+    // records the step when it goes out of scope, which is after the step's result is constructed
+    struct StepRecorder {
+        StartupTimeline &timeline;
+        const std::string &name;
+        clock::time_point step_start;
+        ~StepRecorder() { timeline.record(name, step_start, clock::now()); }
+    };
+
+    void record(const std::string &name, clock::time_point step_start, clock::time_point step_end);
+
+    clock::time_point start;
+    mutable std::mutex steps_mutex;
+    std::vector<Step> steps;
+};
+
+#endif // STARTUP_TIMELINE_HPP
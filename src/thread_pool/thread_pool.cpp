@@ -0,0 +1,97 @@
+#include "thread_pool.hpp"
+
+namespace {
+// which pool and queue the current thread works for, tasks submitted from a worker stay on its own queue
+thread_local const WorkStealingThreadPool *current_pool = nullptr;
+thread_local unsigned int current_worker_index = 0;
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned int num_threads) {
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+    for (unsigned int i = 0; i < num_threads; i++) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    threads.reserve(num_threads);
+    for (unsigned int i = 0; i < num_threads; i++) {
+        threads.emplace_back(&WorkStealingThreadPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_up.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingThreadPool::push_task(std::function<void()> task) {
+    unsigned int queue_index =
+        current_pool == this ? current_worker_index : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+        queues[queue_index]->tasks.push_back(std::move(task));
+    }
+    {
+        // taking the lock makes sure a worker about to sleep sees the new task count
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        num_pending_tasks++;
+    }
+    wake_up.notify_one();
+}
+
+bool WorkStealingThreadPool::try_pop_own(unsigned int queue_index, std::function<void()> &task) {
+    std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+    if (queues[queue_index]->tasks.empty()) {
+        return false;
+    }
+    task = std::move(queues[queue_index]->tasks.back());
+    queues[queue_index]->tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingThreadPool::try_steal(unsigned int thief_index, std::function<void()> &task) {
+    for (unsigned int offset = 1; offset <= queues.size(); offset++) {
+        TaskQueue &victim = *queues[(thief_index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (not victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::run_pending_task() {
+    std::function<void()> task;
+    unsigned int index = current_pool == this ? current_worker_index : 0;
+    if ((current_pool == this and try_pop_own(index, task)) or try_steal(index, task)) {
+        num_pending_tasks--;
+        task();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::worker_loop(unsigned int worker_index) {
+    current_pool = this;
+    current_worker_index = worker_index;
+
+    while (true) {
+        if (run_pending_task()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake_up.wait(lock, [&] { return stopping or num_pending_tasks > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
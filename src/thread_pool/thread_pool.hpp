@@ -0,0 +1,78 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed size thread pool where every worker has its own task deque and idle workers steal from the others.
+ *
+ * Workers take their own newest task first (good locality for tasks that submit more tasks) and steal the oldest
+ * task from someone else when they run dry. Threads outside the pool that wait on a result should use wait_for,
+ * which runs queued tasks while waiting instead of blocking, so waiting can never starve the pool.
+ */
+class WorkStealingThreadPool {
+  public:
+    explicit WorkStealingThreadPool(unsigned int num_threads = std::thread::hardware_concurrency());
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+    WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+    template <typename F> std::future<std::invoke_result_t<F>> submit(F &&task) {
+        using Result = std::invoke_result_t<F>;
+        // std::function needs something copyable, packaged_task is move only
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        push_task([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * @brief Runs a single queued task on the calling thread.
+     * @return false if there was nothing to run.
+     */
+    bool run_pending_task();
+
+    template <typename T> T wait_for(std::future<T> &future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (not run_pending_task()) {
+                std::this_thread::yield();
+            }
+        }
+        return future.get();
+    }
+
+    unsigned int get_num_threads() const { return threads.size(); }
+
+  private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void push_task(std::function<void()> task);
+    bool try_pop_own(unsigned int queue_index, std::function<void()> &task);
+    bool try_steal(unsigned int thief_index, std::function<void()> &task);
+    void worker_loop(unsigned int worker_index);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<unsigned int> next_queue{0};
+    std::atomic<int> num_pending_tasks{0};
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake_up;
+};
+
+#endif // THREAD_POOL_HPP
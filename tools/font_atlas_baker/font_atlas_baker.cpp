@@ -0,0 +1,117 @@
+#include "../../src/graphics/baked_font_atlas/baked_font_atlas.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Bakes a signed distance field font atlas, its two jsons and png, into the single binary file BakedFontAtlas
+ * memory maps, so the game doesn't parse json or decode a png for it at startup.
+ *
+ * usage: font_atlas_baker FONT_INFO_JSON SUB_TEXTURES_JSON ATLAS_PNG OUTPUT
+ *
+ * The build runs this over assets/fonts, it only needs running by hand for an atlas that isn't there.
+ */
+
+nlohmann::json read_json(const std::string &path) {
+    std::ifstream file(path);
+    if (not file) {
+        throw std::runtime_error("unable to open " + path);
+    }
+    return nlohmann::json::parse(file);
+}
+
+/**
+ * @return the codepoint of a json key holding one character, it's utf-8 so anything past ascii takes a few bytes.
+ */
+std::uint32_t decode_codepoint(const std::string &character) {
+    auto byte = [&](std::size_t i) { return static_cast<std::uint8_t>(character[i]); };
+    std::size_t length = character.size();
+    if (length == 1 and byte(0) < 0x80) {
+        return byte(0);
+    }
+    if (length == 2 and (byte(0) & 0xE0) == 0xC0) {
+        return ((byte(0) & 0x1F) << 6) | (byte(1) & 0x3F);
+    }
+    if (length == 3 and (byte(0) & 0xF0) == 0xE0) {
+        return ((byte(0) & 0x0F) << 12) | ((byte(1) & 0x3F) << 6) | (byte(2) & 0x3F);
+    }
+    if (length == 4 and (byte(0) & 0xF8) == 0xF0) {
+        return ((byte(0) & 0x07) << 18) | ((byte(1) & 0x3F) << 12) | ((byte(2) & 0x3F) << 6) | (byte(3) & 0x3F);
+    }
+    throw std::runtime_error("atlas key isn't a single character: " + character);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        std::cerr << "usage: font_atlas_baker FONT_INFO_JSON SUB_TEXTURES_JSON ATLAS_PNG OUTPUT" << std::endl;
+        return 1;
+    }
+    std::string font_info_path = argv[1];
+    std::string sub_textures_path = argv[2];
+    std::string image_path = argv[3];
+    std::string output_path = argv[4];
+
+    try {
+        nlohmann::json font_info = read_json(font_info_path);
+        nlohmann::json sub_textures = read_json(sub_textures_path).at("sub_textures");
+
+        // the table is indexed by codepoint, so it's as long as the largest one
+        std::uint32_t max_codepoint = 0;
+        for (const auto &[character, metrics] : font_info.at("characters").items()) {
+            max_codepoint = std::max(max_codepoint, decode_codepoint(character));
+        }
+        std::vector<BakedGlyph> glyphs(max_codepoint + 1, BakedGlyph{});
+
+        for (const auto &[character, metrics] : font_info.at("characters").items()) {
+            auto sub_texture = sub_textures.find(character);
+            if (sub_texture == sub_textures.end()) {
+                std::cerr << "no sub texture for \"" << character << "\", leaving it out" << std::endl;
+                continue;
+            }
+            BakedGlyph &glyph = glyphs[decode_codepoint(character)];
+            glyph.x = sub_texture->at("x").get<float>();
+            // the json's y is the glyph's top edge, the table holds its bottom one like its x is the left one
+            glyph.y = sub_texture->at("y").get<float>() - sub_texture->at("height").get<float>();
+            glyph.width = sub_texture->at("width").get<float>();
+            glyph.height = sub_texture->at("height").get<float>();
+            glyph.origin_x = metrics.at("originX").get<float>();
+            glyph.origin_y = metrics.at("originY").get<float>();
+            glyph.advance = metrics.at("advance").get<float>();
+            glyph.present = 1;
+        }
+
+        int width, height, channels;
+        unsigned char *image = stbi_load(image_path.c_str(), &width, &height, &channels, 4);
+        if (not image) {
+            throw std::runtime_error("unable to load " + image_path + ": " + stbi_failure_reason());
+        }
+        // the distance is in the red channel, which is all the shaders read. the rows are flipped so the bottom one
+        // comes first, matching both the jsons' y and gl's texture origin
+        std::vector<std::uint8_t> texels(static_cast<std::size_t>(width) * height);
+        for (int row = 0; row < height; row++) {
+            const unsigned char *source_row = image + 4 * static_cast<std::size_t>(height - 1 - row) * width;
+            for (int col = 0; col < width; col++) {
+                texels[static_cast<std::size_t>(row) * width + col] = source_row[4 * col];
+            }
+        }
+        stbi_image_free(image);
+
+        BakedFontAtlas::write(output_path, font_info.at("size").get<int>(), width, height, glyphs, texels);
+        std::cout << "baked " << std::count_if(glyphs.begin(), glyphs.end(), [](const BakedGlyph &glyph) {
+            return glyph.present;
+        }) << " glyphs and a " << width << "x" << height << " atlas into " << output_path << std::endl;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}